@@ -130,6 +130,29 @@ namespace DroidV8Test.Droid
         {
             context = new JSContext();
         }
+
+        /// <summary>
+        /// Evaluates script on a context with its own thread and waits up to
+        /// 5 seconds for script to call done(value), returns the value as string.
+        /// </summary>
+        protected static async Task<string> RunUntilDone(string script)
+        {
+            using (var jc = new JSContext())
+            {
+                jc.StartThread();
+                var result = new TaskCompletionSource<string>();
+                await jc.Post(() => {
+                    jc["done"] = jc.CreateFunction(1, (c, a) => {
+                        result.TrySetResult(a[0].ToString());
+                        return c.Undefined;
+                    }, "done");
+                    jc.Evaluate(script);
+                });
+                var done = await Task.WhenAny(result.Task, Task.Delay(5000));
+                Assert.True(done == result.Task);
+                return result.Task.Result;
+            }
+        }
                 
 
     }
@@ -0,0 +1,40 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class CallStatsTest: BaseTest
+    {
+
+        [Test]
+        public void CountsEvaluate()
+        {
+            JSContext.ResetCallStats();
+            context.Evaluate("1 + 1");
+            context.Evaluate("2 + 2");
+            var stats = JSContext.GetCallStats();
+            if (stats.Count == 0)
+            {
+                // native library built without XV8_CALL_STATS
+                return;
+            }
+            var evaluate = stats.First(x => x.Name == "V8Context_Evaluate");
+            Assert.True(evaluate.Count >= 2);
+            Assert.Equal(evaluate.Count, evaluate.Histogram.Sum());
+
+            JSContext.ResetCallStats();
+            Assert.Equal(0L, JSContext.GetCallStats().First(x => x.Name == "V8Context_Evaluate").Count);
+        }
+
+    }
+}
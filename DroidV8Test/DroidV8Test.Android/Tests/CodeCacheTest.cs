@@ -0,0 +1,41 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class CodeCacheTest: BaseTest
+    {
+        const string Script = "function add(a, b) { return a + b; } add(4, 5)";
+
+        [Test]
+        public void WarmCodeCache()
+        {
+            byte[] cache;
+            using (var script = context.CompileScript(Script, "add.js"))
+            {
+                var r = script.Run();
+                Assert.Equal(9, r.IntValue);
+                cache = script.CreateCodeCache();
+                Assert.True(cache.Length > 0);
+            }
+
+            using (var jc = new JSContext())
+            using (var script = jc.CompileScript(Script, "add.js", cache))
+            {
+                Assert.False(script.CacheRejected);
+                Assert.Equal(9, script.Run().IntValue);
+            }
+        }
+
+    }
+}
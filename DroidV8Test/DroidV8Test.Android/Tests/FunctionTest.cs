@@ -2,6 +2,7 @@
 using System.Collections.Generic;
 using System.Linq;
 using System.Text;
+using System.Threading.Tasks;
 
 using Android.App;
 using Android.Content;
@@ -10,6 +11,7 @@ using Android.Runtime;
 using Android.Views;
 using Android.Widget;
 using WebAtoms;
+using Xamarin.Android.V8;
 
 namespace DroidV8Test.Droid.Tests
 {
@@ -68,6 +70,42 @@ namespace DroidV8Test.Droid.Tests
             Assert.Equal(m, context.Deserialize<Math>(mv));
         }
 
+        [Test]
+        public async Task InvokeAsync()
+        {
+            var fx = (JSValue)context.Evaluate("(async function(x) { await null; return x * 2; })");
+            var r = await fx.InvokeFunctionAsync(null, context.CreateNumber(21));
+            Assert.Equal(42, r.IntValue);
+
+            var fail = (JSValue)context.Evaluate("(async function() { throw new Error('failed'); })");
+            try
+            {
+                await fail.InvokeFunctionAsync(null);
+                Assert.Throw("Not possible");
+            }
+            catch (JavaScriptException ex)
+            {
+                Assert.True(ex.Message.Contains("failed"));
+            }
+        }
+
+        [Test]
+        public async Task InvokeAsyncPending()
+        {
+            using (var jc = new JSContext())
+            {
+                jc.StartThread();
+                var task = await jc.Post(() => {
+                    var fx = (JSValue)jc.Evaluate("(function(x) { return new Promise(r => setTimeout(() => r(x * 2), 10)); })");
+                    return fx.InvokeFunctionAsync(null, jc.CreateNumber(21));
+                });
+                var done = await Task.WhenAny(task, Task.Delay(5000));
+                Assert.True(done == task);
+                var n = await jc.Post(() => task.Result.IntValue);
+                Assert.Equal(42, n);
+            }
+        }
+
     }
 
     public class Math
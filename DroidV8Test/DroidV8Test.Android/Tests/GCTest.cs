@@ -34,5 +34,44 @@ namespace DroidV8Test.Droid.Tests
             // Assert.False(r.IsAlive);
         }
 
+        [Test]
+        public void PumpPlatformTasks()
+        {
+            // survives scavenges while it grows, so it is promoted and old space
+            // garbage is left for incremental marking and memory reducer tasks
+            context.Evaluate("var list = []; for (var i = 0; i < 500000; i++) { list.push({ i: i, s: 'item' + i }); } list = null;");
+            var before = context.GetHeapStatistics().UsedHeapSize;
+            var used = before;
+            var end = DateTime.UtcNow.AddSeconds(15);
+            while (used >= before && DateTime.UtcNow < end)
+            {
+                context.PumpMessageLoop(1000);
+                context.RunIdleTasks(0.05);
+                used = context.GetHeapStatistics().UsedHeapSize;
+                System.Threading.Thread.Sleep(10);
+            }
+            Assert.True(used < before);
+        }
+
+        [Test]
+        public void HeapStatistics()
+        {
+            var before = context.GetHeapStatistics();
+            Assert.True(before.UsedHeapSize > 0);
+            Assert.True(before.HeapSizeLimit >= before.TotalHeapSize);
+            Assert.True(before.Spaces.Length > 0);
+            Assert.True(before.Spaces.Any(x => x.Name == "old_space"));
+            Assert.Equal(0L, before.CodeAndMetadataSize);
+
+            var kept = context.Evaluate("({ kept: true })");
+            var wrapped = context.Wrap(new object());
+            var after = context.GetHeapStatistics(true);
+            Assert.True(after.LiveHandles > before.LiveHandles);
+            Assert.True(after.LiveWrappers > before.LiveWrappers);
+            Assert.True(after.BytecodeAndMetadataSize > 0);
+            GC.KeepAlive(kept);
+            GC.KeepAlive(wrapped);
+        }
+
     }
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Net.Http;
+using System.Net.WebSockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class InspectorTest: BaseTest
+    {
+
+        class RecordingProtocol : V8InspectorProtocol
+        {
+            public readonly List<string> Messages = new List<string>();
+
+            public override void Dispose()
+            {
+            }
+
+            public override Task ConnectAsync(Action<string> onMessageReceived)
+            {
+                return Task.CompletedTask;
+            }
+
+            public override void SendMessage(string message)
+            {
+                Messages.Add(message);
+            }
+        }
+
+        [Test]
+        public void Utf8Chunks()
+        {
+            var p = new RecordingProtocol();
+            var bytes = Encoding.UTF8.GetBytes("{\"text\":\"é😀\"}");
+            p.SendMessage(bytes.Take(10).ToArray(), false);
+            p.SendMessage(bytes.Skip(10).ToArray(), true);
+            p.SendMessage(Encoding.UTF8.GetBytes("{}"), true);
+            Assert.Equal(2, p.Messages.Count);
+            Assert.Equal("{\"text\":\"é😀\"}", p.Messages[0]);
+            Assert.Equal("{}", p.Messages[1]);
+        }
+
+        [Test]
+        public async Task NativeServerEvaluate()
+        {
+            using (var jc = new JSContext(true, 9339, true))
+            {
+                jc.StartThread();
+
+                using (var http = new HttpClient())
+                {
+                    var list = await http.GetStringAsync("http://127.0.0.1:9339/json");
+                    Assert.True(list.Contains("ws://127.0.0.1:9339/"));
+                }
+
+                using (var ws = new ClientWebSocket())
+                {
+                    await ws.ConnectAsync(new Uri("ws://127.0.0.1:9339/xv8"), CancellationToken.None);
+                    var request = Encoding.UTF8.GetBytes(
+                        "{\"id\":1,\"method\":\"Runtime.evaluate\",\"params\":{\"expression\":\"'é' + (1 + 2)\"}}");
+                    await ws.SendAsync(new ArraySegment<byte>(request), WebSocketMessageType.Text, true, CancellationToken.None);
+
+                    var response = new StringBuilder();
+                    var buffer = new byte[4096];
+                    using (var timeout = new CancellationTokenSource(5000))
+                    {
+                        while (true)
+                        {
+                            var r = await ws.ReceiveAsync(new ArraySegment<byte>(buffer), timeout.Token);
+                            response.Append(Encoding.UTF8.GetString(buffer, 0, r.Count));
+                            if (r.EndOfMessage)
+                                break;
+                        }
+                    }
+                    var text = response.ToString();
+                    Assert.True(text.Contains("\"id\":1"));
+                    Assert.True(text.Contains("é3"));
+                }
+            }
+        }
+
+        [Test]
+        public async Task AttachDetach()
+        {
+            using (var jc = new JSContext())
+            {
+                jc.AttachInspector(V8InspectorProtocol.CreateNativeServer(9340));
+                using (var http = new HttpClient())
+                {
+                    var list = await http.GetStringAsync("http://127.0.0.1:9340/json/list");
+                    Assert.True(list.Contains("webSocketDebuggerUrl"));
+                }
+
+                Assert.True(jc.DetachInspector());
+                Assert.False(jc.DetachInspector());
+                Assert.Equal(3, jc.Evaluate("1 + 2").IntValue);
+
+                // can be attached again after detach
+                jc.AttachInspector(V8InspectorProtocol.CreateNativeServer(9340));
+                Assert.True(jc.DetachInspector());
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class PoolTest: BaseTest
+    {
+
+        [Test]
+        public void AcquireFromPool()
+        {
+            JSContext.Prewarm(2);
+            WaitForReady();
+            var hits = JSContext.GetPoolStatistics().Hits;
+            using (var jc = new JSContext())
+            {
+                Assert.Equal(hits + 1, JSContext.GetPoolStatistics().Hits);
+                jc["n5"] = jc.CreateNumber(5);
+                var a = jc.Evaluate("4 + n5");
+                Assert.Equal(9, a.IntValue);
+            }
+        }
+
+        [Test]
+        public void RecycleToPool()
+        {
+            JSContext.Prewarm(1, recycle: true);
+            var recycled = JSContext.GetPoolStatistics().Recycled;
+            // context is taken back only while pool is below its target, so first
+            // iterations drain contexts left by other tests and refill may win a race
+            for (int i = 0; i < 10 && JSContext.GetPoolStatistics().Recycled == recycled; i++)
+            {
+                using (var jc = new JSContext())
+                {
+                    jc.Evaluate("var leftover = 1;");
+                }
+            }
+            Assert.True(JSContext.GetPoolStatistics().Recycled > recycled);
+
+            WaitForReady();
+            var hits = JSContext.GetPoolStatistics().Hits;
+            using (var jc = new JSContext())
+            {
+                Assert.Equal(hits + 1, JSContext.GetPoolStatistics().Hits);
+                // reset context must not keep globals of its previous owner
+                Assert.Equal("undefined", jc.Evaluate("typeof leftover").ToString());
+            }
+            JSContext.Prewarm(0);
+        }
+
+        private static void WaitForReady()
+        {
+            // pool is filled on a background thread
+            for (int i = 0; i < 500 && JSContext.GetPoolStatistics().Ready == 0; i++)
+            {
+                System.Threading.Thread.Sleep(10);
+            }
+            Assert.True(JSContext.GetPoolStatistics().Ready > 0);
+        }
+
+    }
+}
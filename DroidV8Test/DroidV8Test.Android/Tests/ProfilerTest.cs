@@ -0,0 +1,98 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class ProfilerTest: BaseTest
+    {
+
+        [Test]
+        public void CpuProfile()
+        {
+            var path = System.IO.Path.Combine(System.IO.Path.GetTempPath(), "cpu-profile-test.cpuprofile");
+            Assert.True(context.StartCpuProfile("test", TimeSpan.FromMilliseconds(0.05)));
+            Assert.False(context.StartCpuProfile("test"));
+            context.Evaluate(@"function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+                fib(25);", "fib.js");
+            context.StopCpuProfile("test", path);
+
+            var text = System.IO.File.ReadAllText(path);
+            System.IO.File.Delete(path);
+            Assert.True(text.StartsWith("{\"nodes\":[{\"id\":1,"));
+            Assert.True(text.Contains("\"functionName\":\"fib\""));
+            Assert.True(text.Contains("\"timeDeltas\":["));
+
+            try
+            {
+                context.StopCpuProfile("test", path);
+                Assert.Throw("Profile was already stopped");
+            } catch (JavaScriptException)
+            {
+            }
+        }
+
+        [Test]
+        public void HeapSnapshot()
+        {
+            var path = System.IO.Path.Combine(System.IO.Path.GetTempPath(), "heap-snapshot-test.heapsnapshot");
+            var kept = context.Evaluate("({ name: 'kept by clr' })");
+            context.WriteHeapSnapshot(path);
+
+            var text = System.IO.File.ReadAllText(path);
+            System.IO.File.Delete(path);
+            Assert.True(text.StartsWith("{\"snapshot\":"));
+            Assert.True(text.Contains("CLR handles"));
+            GC.KeepAlive(kept);
+        }
+
+        [Test]
+        public void AllocationSampling()
+        {
+            var path = System.IO.Path.Combine(System.IO.Path.GetTempPath(), "allocation-test.heapprofile");
+            Assert.True(context.StartAllocationSampling(1024));
+            Assert.False(context.StartAllocationSampling());
+            context.Evaluate(@"var kept = [];
+                function allocate() { for (var i = 0; i < 10000; i++) { kept.push({ i: i, s: 'item' + i }); } }
+                allocate();", "allocate.js");
+            context.StopAllocationSampling(path);
+
+            var text = System.IO.File.ReadAllText(path);
+            System.IO.File.Delete(path);
+            Assert.True(text.StartsWith("{\"head\":{\"callFrame\":"));
+            Assert.True(text.Contains("\"functionName\":\"allocate\""));
+        }
+
+        [Test]
+        public void Tracing()
+        {
+            var path = System.IO.Path.Combine(System.IO.Path.GetTempPath(), "trace-test.json");
+            context.StartTracing(path);
+            context.Evaluate("function add(a, b) { return a + b; } add(1, 2);", "add.js");
+            context.StopTracing();
+
+            var text = System.IO.File.ReadAllText(path);
+            System.IO.File.Delete(path);
+            Assert.True(text.StartsWith("{\"traceEvents\":["));
+            Assert.True(text.EndsWith("]}"));
+            Assert.True(text.Contains("\"name\":\"V8Context_Evaluate\""));
+
+            try
+            {
+                context.StopTracing();
+                Assert.Throw("Tracing was already stopped");
+            } catch (JavaScriptException)
+            {
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class RealmTest: BaseTest
+    {
+
+        [Test]
+        public void SeparateGlobals()
+        {
+            context["n5"] = context.CreateNumber(5);
+            var realm = context.CreateRealm("plugin");
+            var a = context.EvaluateInRealm(realm, "typeof n5");
+            Assert.Equal("undefined", a.ToString());
+
+            realm["n4"] = context.CreateNumber(4);
+            a = context.EvaluateInRealm(realm, "n4 + 1");
+            Assert.Equal(5, a.IntValue);
+
+            Assert.True(context.DisposeRealm(realm));
+        }
+
+        [Test]
+        public void CrossRealmCall()
+        {
+            var realm = context.CreateRealm("plugin");
+            var add = context.EvaluateInRealm(realm, "(function(a, b) { return a + b; })");
+            context["add"] = add;
+            var r = context.Evaluate("add(4, 5)");
+            Assert.Equal(9, r.IntValue);
+        }
+
+        [Test]
+        public void RejectsObjectThatIsNotRealm()
+        {
+            var realm = context.CreateRealm("plugin");
+            Assert.True(context.DisposeRealm(realm));
+            foreach (var target in new [] { context.CreateObject(), realm })
+            {
+                try
+                {
+                    context.EvaluateInRealm(target, "1");
+                    Assert.Throw("Expecting an exception");
+                } catch (JavaScriptException ex)
+                {
+                    Assert.True(ex.Message.Contains("live realm"));
+                }
+            }
+        }
+
+    }
+}
@@ -90,5 +90,35 @@ namespace DroidV8Test.Droid.Tests
             }
 
         }
+
+        [Test]
+        public void EvaluateFileTest()
+        {
+            var path = System.IO.Path.Combine(System.IO.Path.GetTempPath(), "evaluate-file-test.js");
+            System.IO.File.WriteAllText(path, "var firstName = 'Akash'; `${firstName} Kava`");
+            var a = context.EvaluateFile(path);
+            Assert.Equal("Akash Kava", a.ToString());
+
+            System.IO.File.WriteAllText(path, "'Akash \u00e9 Kava \u20ac'.length + 'é€'.length");
+            a = context.EvaluateFile(path);
+            Assert.Equal(16, a.IntValue);
+
+            System.IO.File.WriteAllText(path, "");
+            a = context.EvaluateFile(path);
+            Assert.True(a.IsUndefined);
+            System.IO.File.Delete(path);
+        }
+
+        [Test]
+        public void ExplicitMicrotaskCheckpoint()
+        {
+            context.SetMicrotaskPolicy(MicrotaskPolicy.Explicit);
+            context.Evaluate("var log = []; Promise.resolve().then(() => log.push('p')); queueMicrotask(() => log.push('q'));");
+            Assert.Equal(0, context.Evaluate("log.length").IntValue);
+
+            context.PerformMicrotaskCheckpoint();
+            Assert.Equal("p,q", context.Evaluate("log.join()").ToString());
+            context.SetMicrotaskPolicy(MicrotaskPolicy.Auto);
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    /// <summary>
+    /// Measures CreateString and SetProperty throughput for ASCII, Latin-1 and
+    /// non Latin-1 text, short keys and long values, results are written to debug output.
+    /// </summary>
+    public class StringBenchmark: BaseTest
+    {
+        const int Iterations = 20000;
+
+        private static string[] Corpus(string alphabet, int length, int count)
+        {
+            var r = new Random(1);
+            var list = new string[count];
+            var sb = new StringBuilder();
+            for (int i = 0; i < count; i++)
+            {
+                sb.Clear();
+                for (int j = 0; j < length; j++)
+                {
+                    sb.Append(alphabet[r.Next(alphabet.Length)]);
+                }
+                list[i] = sb.ToString();
+            }
+            return list;
+        }
+
+        private static IEnumerable<(string name, string[] corpus)> Corpora()
+        {
+            const string ascii = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-";
+            const string latin1 = ascii + "àáâãäåçèéêëìíîïñòóôõöùúûüý";
+            const string mixed = latin1 + "€αβγδ日本語中文한국어";
+            foreach (var (name, alphabet) in new[] { ("ascii", ascii), ("latin1", latin1), ("mixed", mixed) })
+            {
+                yield return ($"{name}-16", Corpus(alphabet, 16, 256));
+                yield return ($"{name}-1024", Corpus(alphabet, 1024, 64));
+            }
+        }
+
+        private static void Report(string test, string corpus, int count, Stopwatch sw)
+        {
+            var perSecond = count / sw.Elapsed.TotalSeconds;
+            System.Diagnostics.Debug.WriteLine($"{test} {corpus}: {perSecond:N0} ops/s");
+        }
+
+        [Test]
+        public void CreateStringThroughput()
+        {
+            foreach (var (name, corpus) in Corpora())
+            {
+                var sw = Stopwatch.StartNew();
+                for (int i = 0; i < Iterations; i++)
+                {
+                    context.CreateString(corpus[i % corpus.Length]);
+                }
+                sw.Stop();
+                Report("CreateString", name, Iterations, sw);
+            }
+        }
+
+        [Test]
+        public void SetPropertyThroughput()
+        {
+            var target = context.CreateObject();
+            var value = context.CreateNumber(1);
+            foreach (var (name, corpus) in Corpora())
+            {
+                var sw = Stopwatch.StartNew();
+                for (int i = 0; i < Iterations; i++)
+                {
+                    target[corpus[i % corpus.Length]] = value;
+                }
+                sw.Stop();
+                Report("SetProperty", name, Iterations, sw);
+            }
+        }
+
+    }
+}
@@ -0,0 +1,87 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class ThreadTest: BaseTest
+    {
+
+        [Test]
+        public async Task EvaluateOnThread()
+        {
+            using (var jc = new JSContext())
+            {
+                jc.StartThread();
+                var r = await jc.Post(() => jc.Evaluate("(function f(n) { return n < 2 ? n : f(n - 1) + f(n - 2); })(20)").IntValue);
+                Assert.Equal(6765, r);
+
+                await jc.Post(() => jc["n5"] = jc.CreateNumber(5));
+                r = await jc.Post(() => jc.Evaluate("n5 + 4").IntValue);
+                Assert.Equal(9, r);
+            }
+        }
+
+        [Test]
+        public async Task LockFromBackgroundThreads()
+        {
+            using (var jc = new JSContext())
+            {
+                jc.EnableLocking();
+                jc.Evaluate("var n = 0;");
+                var all = Enumerable.Range(0, 4).Select(i => Task.Run(() => {
+                    for (int j = 0; j < 100; j++)
+                    {
+                        using (jc.Lock())
+                        {
+                            var n = jc["n"].IntValue;
+                            jc["n"] = jc.CreateNumber(n + 1);
+                        }
+                    }
+                }));
+                await Task.WhenAll(all);
+                Assert.Equal(400, jc.Evaluate("n").IntValue);
+            }
+        }
+
+        [Test]
+        public async Task InterruptRunningScript()
+        {
+            using (var jc = new JSContext())
+            {
+                jc.StartThread();
+                await jc.Post(() => jc.Evaluate("var stop = false;"));
+                var running = jc.Post(() => jc.Evaluate("while(!stop) { }"));
+
+                // runs in between iterations of the loop above
+                await jc.RequestInterrupt(() => jc["stop"] = jc.True);
+                var done = await Task.WhenAny(running, Task.Delay(5000));
+                Assert.True(done == running);
+            }
+        }
+
+        [Test]
+        public void InterruptCancelledOnDispose()
+        {
+            Task pending;
+            using (var jc = new JSContext())
+            {
+                // no script runs, so V8 never fires it
+                pending = jc.RequestInterrupt(() => jc["stop"] = jc.True);
+                Assert.False(pending.IsCompleted);
+            }
+            Assert.True(pending.IsCanceled);
+        }
+
+    }
+}
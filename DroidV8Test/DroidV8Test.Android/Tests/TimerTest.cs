@@ -0,0 +1,49 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class TimerTest: BaseTest
+    {
+
+        [Test]
+        public async Task TimeoutOrder()
+        {
+            var r = await RunUntilDone(@"
+                var log = [];
+                setTimeout(function() { log.push('c'); done(log.join('')); }, 30);
+                setTimeout(function(x) { log.push(x); }, 10, 'b');
+                setTimeout(function() { log.push('a'); }, 0);
+                var t = setTimeout(function() { log.push('x'); }, 5);
+                clearTimeout(t);");
+            Assert.Equal("abc", r);
+        }
+
+        [Test]
+        public async Task Interval()
+        {
+            var r = await RunUntilDone(@"
+                var n = 0;
+                var i = setInterval(function() {
+                    n++;
+                    if (n === 3) {
+                        clearInterval(i);
+                        setTimeout(function() { done(n); }, 50);
+                    }
+                }, 5);");
+            Assert.Equal("3", r);
+        }
+
+    }
+}
@@ -0,0 +1,57 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class WatchdogTest: BaseTest
+    {
+
+        [Test]
+        public void EvaluateTerminated()
+        {
+            try
+            {
+                context.Evaluate("while(true) {}", TimeSpan.FromMilliseconds(100));
+                Assert.Throw("Expecting termination");
+            } catch (JavaScriptTerminatedException)
+            {
+            }
+
+            // termination is cancelled, context is still usable
+            Assert.Equal(3, context.Evaluate("1 + 2").IntValue);
+            Assert.Equal(4, context.Evaluate("2 + 2", TimeSpan.FromSeconds(5)).IntValue);
+        }
+
+        [Test]
+        public void InvokeFunctionTerminated()
+        {
+            var fx = (JSValue)context.Evaluate("(function(n) { while(n) {} return n; })");
+            try
+            {
+                fx.InvokeFunction(TimeSpan.FromMilliseconds(100), null, context.True);
+                Assert.Throw("Expecting termination");
+            } catch (JavaScriptTerminatedException)
+            {
+            }
+            Assert.False(fx.InvokeFunction(TimeSpan.FromSeconds(5), null, context.False).BooleanValue);
+        }
+
+        [Test]
+        public void CpuTime()
+        {
+            var before = context.CpuTime;
+            context.Evaluate("let s = 0; for(let i = 0; i < 1e7; i++) { s += i; } s");
+            Assert.True(context.CpuTime > before);
+        }
+    }
+}
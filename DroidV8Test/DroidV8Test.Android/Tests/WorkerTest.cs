@@ -0,0 +1,45 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+using Android.App;
+using Android.Content;
+using Android.OS;
+using Android.Runtime;
+using Android.Views;
+using Android.Widget;
+using Xamarin.Android.V8;
+
+namespace DroidV8Test.Droid.Tests
+{
+    public class WorkerTest: BaseTest
+    {
+
+        [Test]
+        public async Task TransferArrayBuffer()
+        {
+            // buffer is detached on this side as soon as it is posted
+            var r = await RunUntilDone(@"
+                var w = new Worker('onmessage = function(e) { var a = new Uint8Array(e.data); a[0] *= 2; postMessage(e.data, [e.data]); }');
+                var b = new ArrayBuffer(8);
+                new Uint8Array(b)[0] = 21;
+                w.postMessage(b, [b]);
+                var detached = b.byteLength;
+                w.onmessage = function(e) { done(detached + ':' + new Uint8Array(e.data)[0]); };");
+            Assert.Equal("0:42", r);
+        }
+
+        [Test]
+        public async Task StructuredClone()
+        {
+            var r = await RunUntilDone(@"
+                var w = new Worker('onmessage = function(e) { postMessage(e.data.items.length + \':\' + e.data.map.get(\'a\')); }');
+                w.onmessage = function(e) { done(e.data); w.terminate(); };
+                w.postMessage({ items: [1, 2, 3], map: new Map([['a', 'b']]) });");
+            Assert.Equal("3:b", r);
+        }
+
+    }
+}
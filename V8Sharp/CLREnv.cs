@@ -24,11 +24,14 @@ namespace Xamarin.Android.V8
         public IntPtr freeHandle;
         public IntPtr externalCall;
         public IntPtr logger;
-        public IntPtr WaitForDebugMessageFromProtocol;
         public IntPtr SendDebugMessageToProtocol;
         public IntPtr fatalErrorCallback;
 
-        public IntPtr breakPauseOn;
+        // queues native task on main thread, task is run with V8Context_PostTask
+        public IntPtr queueTask;
+
+        // receives inspector messages as UTF-8 chunks, SendDebugMessageToProtocol is not used when set
+        public IntPtr SendDebugMessageUtf8ToProtocol;
 
     }
 
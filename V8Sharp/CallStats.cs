@@ -0,0 +1,57 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+namespace Xamarin.Android.V8
+{
+    /// <summary>
+    /// Calls and latency of one native export, collected only when native library
+    /// is built with XV8_CALL_STATS.
+    /// </summary>
+    public class CallStat
+    {
+        public string Name { get; internal set; }
+
+        public long Count { get; internal set; }
+
+        public TimeSpan TotalTime { get; internal set; }
+
+        /// <summary>
+        /// Calls by latency, entry 0 is below 1ns and entry n counts calls that took
+        /// from 2^(n-1) to 2^n nanoseconds, last entry includes everything longer.
+        /// </summary>
+        public long[] Histogram { get; internal set; }
+
+        internal static (bool enabled, List<CallStat> stats) Read(byte[] snapshot)
+        {
+            var list = new List<CallStat>();
+            using (var reader = new BinaryReader(new MemoryStream(snapshot)))
+            {
+                var enabled = reader.ReadInt32() != 0;
+                var buckets = reader.ReadInt32();
+                var count = reader.ReadInt32();
+                for (int i = 0; i < count; i++)
+                {
+                    var name = Encoding.ASCII.GetString(reader.ReadBytes(reader.ReadInt32()));
+                    var calls = reader.ReadInt64();
+                    var nanos = reader.ReadInt64();
+                    var histogram = new long[buckets];
+                    for (int b = 0; b < buckets; b++)
+                    {
+                        histogram[b] = reader.ReadInt64();
+                    }
+                    list.Add(new CallStat
+                    {
+                        Name = name,
+                        Count = calls,
+                        TotalTime = TimeSpan.FromTicks(nanos / 100),
+                        Histogram = histogram
+                    });
+                }
+                return (enabled, list);
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace Xamarin.Android.V8
+{
+    /// <summary>
+    /// Size of one V8 heap space, in bytes
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct HeapSpaceStatistics
+    {
+        [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 32)]
+        public string Name;
+
+        public long Size;
+
+        public long Used;
+
+        public long Available;
+
+        public long Physical;
+    }
+
+    /// <summary>
+    /// Heap of a context filled natively by V8Context_GetHeapStatistics, sizes are in
+    /// bytes. Layout must match __HeapStatistics in V8Context.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct HeapStatistics
+    {
+        internal const int MaxHeapSpaces = 12;
+
+        public long TotalHeapSize;
+
+        public long TotalHeapSizeExecutable;
+
+        public long TotalPhysicalSize;
+
+        public long TotalAvailableSize;
+
+        public long UsedHeapSize;
+
+        public long HeapSizeLimit;
+
+        public long MallocedMemory;
+
+        public long PeakMallocedMemory;
+
+        /// <summary>
+        /// Memory held outside of heap by JS objects, such as array buffers and external strings
+        /// </summary>
+        public long ExternalMemory;
+
+        public long NumberOfNativeContexts;
+
+        /// <summary>
+        /// Contexts no longer used but not yet collected, growing count indicates a leak
+        /// </summary>
+        public long NumberOfDetachedContexts;
+
+        /// <summary>
+        /// Zero unless code statistics were requested
+        /// </summary>
+        public long CodeAndMetadataSize;
+
+        public long BytecodeAndMetadataSize;
+
+        public long ExternalScriptSourceSize;
+
+        /// <summary>
+        /// JS values referenced from CLR that are not released yet
+        /// </summary>
+        public int LiveHandles;
+
+        /// <summary>
+        /// CLR objects wrapped for JS that are still alive in the isolate
+        /// </summary>
+        public int LiveWrappers;
+
+        public int SpaceCount;
+
+        private int reserved;
+
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = MaxHeapSpaces)]
+        public HeapSpaceStatistics[] Spaces;
+    }
+}
@@ -27,8 +27,6 @@ namespace Xamarin.Android.V8
 
     public delegate JSValue Function(JSValue jsThis, JSValue jsArgs);
 
-    internal delegate Utf16IntPtr ReadDebugMessage();
-
     internal delegate void ReadDebugMessageFromV8(
         int len,
         [MarshalAs(UnmanagedType.LPStr, SizeParamIndex = 0)]
@@ -36,6 +34,12 @@ namespace Xamarin.Android.V8
         [MarshalAs(UnmanagedType.LPWStr, SizeParamIndex = 0)]
         string char16);
 
+    internal delegate void ReadDebugMessageUtf8FromV8(
+        IntPtr text,
+        int length,
+        [MarshalAs(UnmanagedType.I1)]
+        bool final);
+
     internal delegate void JSContextLog(IntPtr text, int length);
 
     internal delegate void JSFreeMemory(IntPtr ptr);
@@ -46,9 +50,26 @@ namespace Xamarin.Android.V8
 
     internal delegate void FatalErrorCallback(IntPtr location, IntPtr message);
 
-    internal delegate void BreakPauseOn(bool boolSwitch);
+    internal delegate void QueueTask(IntPtr task, double delay);
+
+    internal delegate void ClrTask(IntPtr data);
+
+    internal delegate void AsyncCompletion(IntPtr token, V8Response result);
 
 
+    public enum MicrotaskPolicy: int
+    {
+        /// <summary>
+        /// Microtasks run after every outermost call into JavaScript
+        /// </summary>
+        Auto = 0,
+
+        /// <summary>
+        /// Microtasks run only when <see cref="JSContext.PerformMicrotaskCheckpoint"/> is called
+        /// </summary>
+        Explicit = 1
+    }
+
     internal enum NullableBool: byte
     {
         NotSet = 0,
@@ -56,56 +77,6 @@ namespace Xamarin.Android.V8
         True = 2
     }
 
-    internal class ReadMessageLock
-    {
-
-        private AutoResetEvent wait;
-        private string value;
-        public ReadMessageLock()
-        {
-
-        }
-
-        public string Read()
-        {
-            AutoResetEvent w;
-            lock(this)
-            {
-                w = wait;
-            }
-            if (w == null)
-                return "{}";
-            
-            w.WaitOne();
-            w.Reset();
-            return value;
-        }
-
-        public bool SendIfWaiting(string message)
-        {
-            lock (this)
-            {
-                if(wait == null)
-                    return false;
-                value = message;
-                wait.Set();
-            }
-            return true;
-        }
-        public void Turn(bool b)
-        {
-            lock(this)
-            {
-                if (b)
-                {
-                    wait = new AutoResetEvent(false);
-                } else
-                {
-                    wait = null;
-                }
-            }
-        }
-    }
     public class JSContext : IJSContext, IDisposable
     {
 
@@ -122,11 +93,15 @@ namespace Xamarin.Android.V8
         static ExternalCall externalCaller;
         static JSAllocateMemory allocateMemory;
         static JSAllocateString allocateString;
+        static JSContextLog poolLogger;
+        static QueueTask queueTask;
+        static ClrTask clrTask;
+        static ClrTask clrCancelTask;
+        internal static AsyncCompletion asyncCompletion;
 
         readonly ReadDebugMessageFromV8 receiveDebugFromV8;
-        readonly ReadDebugMessage readDebugMessage;
+        readonly ReadDebugMessageUtf8FromV8 receiveDebugUtf8FromV8;
         readonly JSContextLog logger;
-        readonly BreakPauseOn breakPauseOn;
 
 
         public Action<string> Logger { get; set; }
@@ -180,7 +155,7 @@ namespace Xamarin.Android.V8
         //            return ElementWrapper;
         //        })()"));
 
-        private readonly V8InspectorProtocol inspectorProtocol;
+        private V8InspectorProtocol inspectorProtocol;
 
         /// <summary>
         /// Creates JSContext with inverse web socket proxy, this is helpful if you do not want to create
@@ -207,7 +182,22 @@ namespace Xamarin.Android.V8
 
         }
 
-        private readonly ReadMessageLock readLock = new ReadMessageLock();
+        /// <summary>
+        /// Creates new JSContext, if nativeInspectorServer is true, inspector is served by
+        /// native code on 127.0.0.1 at webSocketServerPort instead of managed web socket server
+        /// </summary>
+        /// <param name="debug"></param>
+        /// <param name="webSocketServerPort"></param>
+        /// <param name="nativeInspectorServer"></param>
+        public JSContext(bool debug, int webSocketServerPort, bool nativeInspectorServer)
+            : this(debug
+                  ? (nativeInspectorServer
+                    ? V8InspectorProtocol.CreateNativeServer(webSocketServerPort)
+                    : V8InspectorProtocol.CreateWebSocketServer(webSocketServerPort))
+                  : null)
+        {
+
+        }
 
         private JSContext(V8InspectorProtocol protocol = null)
         {
@@ -221,17 +211,13 @@ namespace Xamarin.Android.V8
             };
 
 
-            readDebugMessage = () => readLock.Read();
-
-            breakPauseOn = (b) => readLock.Turn(b);
-
             receiveDebugFromV8 = (n, c8, c16) => {
                 try {
                     if (n > 0)
                     {
                         var msg = c8 ?? c16;                        
                         // Log(msg);
-                        this.inspectorProtocol.SendMessage(msg);
+                        this.inspectorProtocol?.SendMessage(msg);
                     }
                 } catch (Exception ex)
                 {
@@ -239,74 +225,24 @@ namespace Xamarin.Android.V8
                 }
             };
 
-            lock (creationLock)
-            {
-                if (freeHandle == null)
+            receiveDebugUtf8FromV8 = (text, length, final) => {
+                try
                 {
-
-                    fatalErrorCallback = (l, m) => {
-                        string ls = l == IntPtr.Zero ? null : Marshal.PtrToStringAuto(l);
-                        string ms = m == IntPtr.Zero ? null : Marshal.PtrToStringAuto(m);
-                        // Logger?.Invoke(ms);
-                        // Logger?.Invoke(ls);
-
-                        System.Diagnostics.Debug.WriteLine(ms);
-                        System.Diagnostics.Debug.WriteLine(ls);
-                    };
-
-
-                    allocateMemory = (n) =>
-                    {
-                        IntPtr m = Marshal.AllocHGlobal(n);
-                        return m;
-                    };
-
-                    allocateString = (n) => {
-                        var s = new String(' ', n);
-                        Utf16Value v = s;
-                        return v;
-                    };
-
-                    freeMemory = (n) =>
-                    {
-                        Marshal.FreeHGlobal(n);
-                    };
-
-                    freeHandle = (p) =>
-                    {
-                        try
-                        {
-                            GCHandle g = GCHandle.FromIntPtr(p);
-                            if (g.IsAllocated)
-                            {
-                                g.Free();
-                            }
-                        }
-                        catch (Exception ex)
-                        {
-                            System.Diagnostics.Debug.WriteLine(ex);
-                        }
-                    };
-
-                    externalCaller = (fx, t, a) =>
-                    {
-                        try
-                        {
-                            var fxc = fx;
-                            var gc = GCHandle.FromIntPtr(fxc.result.refValue);
-                            var ffx = (CLRExternalCall)gc.Target;
-                            return ffx(t, a);
-                        }
-                        catch (Exception ex)
-                        {
-                            return ex;
-                        }
-                    };
-
+                    // text is only valid during this call
+                    var chunk = new byte[length];
+                    Marshal.Copy(text, chunk, 0, length);
+                    this.inspectorProtocol?.SendMessage(chunk, final);
+                } catch (Exception ex)
+                {
+                    System.Diagnostics.Debug.WriteLine(ex);
                 }
+            };
 
+            lock (creationLock)
+            {
+                InitializeCallbacks();
 
-                this.context = V8Context_Create(
+                this.context = V8Context_AcquireFromPool(
                     protocol != null,
                     new CLREnv
                     {
@@ -318,11 +254,12 @@ namespace Xamarin.Android.V8
                         externalCall = Marshal.GetFunctionPointerForDelegate(externalCaller),
 
                         logger = Marshal.GetFunctionPointerForDelegate(logger),
-                        WaitForDebugMessageFromProtocol = Marshal.GetFunctionPointerForDelegate(readDebugMessage),
                         SendDebugMessageToProtocol = Marshal.GetFunctionPointerForDelegate(receiveDebugFromV8),
                         fatalErrorCallback = Marshal.GetFunctionPointerForDelegate(fatalErrorCallback),
 
-                        breakPauseOn = Marshal.GetFunctionPointerForDelegate(breakPauseOn)
+                        queueTask = Marshal.GetFunctionPointerForDelegate(queueTask),
+
+                        SendDebugMessageUtf8ToProtocol = Marshal.GetFunctionPointerForDelegate(receiveDebugUtf8FromV8)
                     });
             }
             
@@ -338,40 +275,192 @@ namespace Xamarin.Android.V8
 
             this.WrappedSymbol = new JSValue(this, V8Context_CreateSymbol(context, "WrappedSymbol"));
 
-            // Add SetTimeout...
+            if (protocol != null)
+            {
+                ConnectProtocol(protocol);
+            }
 
-            Dictionary<int, IDisposable> timeouts = new Dictionary<int, IDisposable>();
+        }
 
-            int id = 0;
+        /// <summary>
+        /// Creates isolates in background so that new JSContext gets one instantly,
+        /// if recycle is true, disposed contexts are reset and returned to the pool.
+        /// </summary>
+        /// <param name="count">Number of contexts to keep ready</param>
+        /// <param name="recycle"></param>
+        public static void Prewarm(int count, bool recycle = false)
+        {
+            lock (creationLock)
+            {
+                InitializeCallbacks();
 
-            this["clearTimeout"] = this.CreateFunction(1, (c, a) => {
-                var tid = a[0].IntValue;
-                if(timeouts.TryGetValue(tid, out var token))
+                if (poolLogger == null)
                 {
-                    token.Dispose();
+                    poolLogger = (t, l) => System.Diagnostics.Debug.WriteLine(t.ToUtf16String(l));
                 }
-                return this.Undefined;
-            }, "clearTimeout");
 
-            this["setTimeout"] = this.CreateFunction(2, (c, a) => {
+                V8Context_SetPoolPolicy(recycle ? 1 : 0);
+                V8Context_Prewarm(count, new CLREnv
+                {
+                    allocateMemory = Marshal.GetFunctionPointerForDelegate(allocateMemory),
+                    allocateString = Marshal.GetFunctionPointerForDelegate(allocateString),
+                    freeMemory = Marshal.GetFunctionPointerForDelegate(freeMemory),
 
-                var fn = a[0];
-                var timeout = a[1];
-                var delay = timeout.IsUndefined ? 0 : timeout.LongValue;
-                var ct = MainThread.PostTimeout(() => {
-                    fn.InvokeFunction(Global);
-                }, delay);
+                    freeHandle = Marshal.GetFunctionPointerForDelegate(freeHandle),
+                    externalCall = Marshal.GetFunctionPointerForDelegate(externalCaller),
 
-                var tid = System.Threading.Interlocked.Increment(ref id);
-                return this.CreateNumber(tid);
+                    logger = Marshal.GetFunctionPointerForDelegate(poolLogger),
+                    fatalErrorCallback = Marshal.GetFunctionPointerForDelegate(fatalErrorCallback),
 
-            }, "setTimeout");
+                    queueTask = Marshal.GetFunctionPointerForDelegate(queueTask)
+                });
+            }
+        }
 
-            if (protocol != null)
+        /// <summary>
+        /// Calls and latency of every native export called so far, empty unless native
+        /// library was built with XV8_CALL_STATS.
+        /// </summary>
+        public static List<CallStat> GetCallStats()
+        {
+            var r = V8Context_GetCallStats();
+            if (r.Type == V8HandleType.Boolean)
             {
-                MainThread.InvokeOnMainThreadAsync(() => this.SetupDebugging());
+                // no context was created yet
+                return new List<CallStat>();
             }
+            var (enabled, stats) = CallStat.Read(r.GetByteArray());
+            return enabled ? stats : new List<CallStat>();
+        }
 
+        /// <summary>
+        /// Zeroes counters returned by GetCallStats
+        /// </summary>
+        public static void ResetCallStats()
+        {
+            V8Context_ResetCallStats();
+        }
+
+        /// <summary>
+        /// Ready contexts and how often the pool was used, see Prewarm
+        /// </summary>
+        public static PoolStatistics GetPoolStatistics()
+        {
+            V8Context_GetPoolStatistics(out var statistics);
+            return statistics;
+        }
+
+        private static void InitializeCallbacks()
+        {
+            if (freeHandle == null)
+            {
+
+                fatalErrorCallback = (l, m) => {
+                    string ls = l == IntPtr.Zero ? null : Marshal.PtrToStringAuto(l);
+                    string ms = m == IntPtr.Zero ? null : Marshal.PtrToStringAuto(m);
+                    // Logger?.Invoke(ms);
+                    // Logger?.Invoke(ls);
+
+                    System.Diagnostics.Debug.WriteLine(ms);
+                    System.Diagnostics.Debug.WriteLine(ls);
+                };
+
+
+                allocateMemory = (n) =>
+                {
+                    IntPtr m = Marshal.AllocHGlobal(n);
+                    return m;
+                };
+
+                allocateString = (n) => {
+                    var s = new String(' ', n);
+                    Utf16Value v = s;
+                    return v;
+                };
+
+                freeMemory = (n) =>
+                {
+                    Marshal.FreeHGlobal(n);
+                };
+
+                freeHandle = (p) =>
+                {
+                    try
+                    {
+                        GCHandle g = GCHandle.FromIntPtr(p);
+                        if (g.IsAllocated)
+                        {
+                            g.Free();
+                        }
+                    }
+                    catch (Exception ex)
+                    {
+                        System.Diagnostics.Debug.WriteLine(ex);
+                    }
+                };
+
+                queueTask = (task, delay) =>
+                {
+                    MainThread.BeginInvokeOnMainThread(
+                        () => V8Context_PostTask(task),
+                        (long)(delay * 1000));
+                };
+
+                clrTask = (data) =>
+                {
+                    var g = GCHandle.FromIntPtr(data);
+                    var action = (Action<bool>)g.Target;
+                    g.Free();
+                    try
+                    {
+                        action(false);
+                    }
+                    catch (Exception ex)
+                    {
+                        System.Diagnostics.Debug.WriteLine(ex);
+                    }
+                };
+
+                // interrupt dropped because context was disposed or pooled
+                clrCancelTask = (data) =>
+                {
+                    var g = GCHandle.FromIntPtr(data);
+                    var action = (Action<bool>)g.Target;
+                    g.Free();
+                    action(true);
+                };
+
+                asyncCompletion = (token, result) =>
+                {
+                    var g = GCHandle.FromIntPtr(token);
+                    var (owner, tcs) = ((JSContext, TaskCompletionSource<IJSValue>))g.Target;
+                    g.Free();
+                    try
+                    {
+                        tcs.TrySetResult(new JSValue(owner, result));
+                    }
+                    catch (Exception ex)
+                    {
+                        tcs.TrySetException(ex);
+                    }
+                };
+
+                externalCaller = (fx, t, a) =>
+                {
+                    try
+                    {
+                        var fxc = fx;
+                        var gc = GCHandle.FromIntPtr(fxc.result.refValue);
+                        var ffx = (CLRExternalCall)gc.Target;
+                        return ffx(t, a);
+                    }
+                    catch (Exception ex)
+                    {
+                        return ex;
+                    }
+                };
+
+            }
         }
 
         private static void Log(object message)
@@ -379,28 +468,59 @@ namespace Xamarin.Android.V8
             System.Diagnostics.Debug.WriteLine(message);
         }
 
+        private void ConnectProtocol(V8InspectorProtocol protocol)
+        {
+            inspectorProtocol = protocol;
+            if (protocol is V8InspectorProtocolNative native)
+            {
+                V8Context_StartInspectorServer(context, native.Port).ThrowError();
+            }
+            else
+            {
+                MainThread.InvokeOnMainThreadAsync(() => this.SetupDebugging());
+            }
+        }
+
+        /// <summary>
+        /// Attaches inspector to a context created without debugging, so that a release
+        /// build can still be debugged in the field. Inspector has no cost until attached.
+        /// </summary>
+        /// <param name="protocol"></param>
+        public void AttachInspector(V8InspectorProtocol protocol)
+        {
+            if (protocol == null)
+                throw new ArgumentNullException(nameof(protocol));
+            if (!V8Context_AttachInspector(context).GetBooleanValue())
+                throw new InvalidOperationException("Inspector is already attached");
+            ConnectProtocol(protocol);
+        }
+
+        /// <summary>
+        /// Tears down inspector session and disposes its protocol, returns false if
+        /// inspector was not attached.
+        /// </summary>
+        /// <returns></returns>
+        public bool DetachInspector()
+        {
+            if (!V8Context_DetachInspector(context).GetBooleanValue())
+                return false;
+            var protocol = inspectorProtocol;
+            inspectorProtocol = null;
+            protocol?.Dispose();
+            return true;
+        }
+
         private async Task SetupDebugging()
         {
             try
             {
                 await inspectorProtocol.ConnectAsync((msg) =>
                 {
-
-                    if (readLock.SendIfWaiting(msg))
-                        return;
-
-                    MainThread.BeginInvokeOnMainThread(() =>
+                    // queued natively, paused debugger reads it without calling back into CLR
+                    if (!V8Context_PushDebugMessage(context, msg).GetBooleanValue())
                     {
-                        try
-                        {
-                            // System.Diagnostics.Debug.WriteLine(msg);
-                            V8Context_SendDebugMessage(context, msg).GetBooleanValue();
-                        }
-                        catch (Exception ex)
-                        {
-                            Log(ex);
-                        }
-                    });
+                        Log("Debug message dropped, context is disposed");
+                    }
                 });
             } catch (Exception ex)
             {
@@ -483,6 +603,198 @@ namespace Xamarin.Android.V8
             return new JSValue(this, c);
         }
 
+        /// <summary>
+        /// Evaluates script, if it does not finish within timeout, it is terminated and
+        /// <see cref="JavaScriptTerminatedException"/> is thrown. Context stays usable.
+        /// </summary>
+        /// <param name="script"></param>
+        /// <param name="timeout"></param>
+        /// <param name="location"></param>
+        /// <returns></returns>
+        public IJSValue Evaluate(string script, TimeSpan timeout, string location = null)
+        {
+            location = location ?? "vm";
+            var c = V8Context_EvaluateWithBudget(
+                context,
+                script,
+                location,
+                (int)Math.Ceiling(timeout.TotalMilliseconds));
+            return new JSValue(this, c);
+        }
+
+        /// <summary>
+        /// CPU time spent running scripts, callbacks and timers of this context,
+        /// safe to read from any thread.
+        /// </summary>
+        public TimeSpan CpuTime
+        {
+            get
+            {
+                var r = V8Context_GetCpuTime(context);
+                r.ThrowError();
+                return TimeSpan.FromTicks((long)(r.result.doubleValue * TimeSpan.TicksPerMillisecond));
+            }
+        }
+
+        /// <summary>
+        /// Starts sampling CPU profile, returns false if a profile with same title is running.
+        /// With callerLineNumbers, nodes are split by line of call site instead of start of function.
+        /// </summary>
+        /// <param name="title"></param>
+        /// <param name="samplingInterval">Defaults to 100 microseconds</param>
+        /// <param name="callerLineNumbers"></param>
+        /// <returns></returns>
+        public bool StartCpuProfile(string title, TimeSpan? samplingInterval = null, bool callerLineNumbers = false)
+        {
+            var us = samplingInterval == null ? 0 : (int)(samplingInterval.Value.Ticks / 10);
+            return V8Context_StartCpuProfile(context, title, us, callerLineNumbers).GetBooleanValue();
+        }
+
+        /// <summary>
+        /// Stops CPU profile and saves it at path as .cpuprofile, which DevTools can load.
+        /// </summary>
+        /// <param name="title"></param>
+        /// <param name="path"></param>
+        public void StopCpuProfile(string title, string path)
+        {
+            V8Context_StopCpuProfile(context, title, path).ThrowError();
+        }
+
+        /// <summary>
+        /// Writes heap snapshot at path as .heapsnapshot without an inspector connection.
+        /// With includeClrHandles, every handle held by CLR appears as a native node
+        /// retaining its value, so leaks through wrappers are easy to spot.
+        /// </summary>
+        /// <param name="path"></param>
+        /// <param name="includeClrHandles"></param>
+        public void WriteHeapSnapshot(string path, bool includeClrHandles = true)
+        {
+            V8Context_WriteHeapSnapshot(context, path, includeClrHandles).ThrowError();
+        }
+
+        /// <summary>
+        /// Starts sampling heap profiler, an allocation is sampled every intervalBytes on
+        /// average with up to stackDepth frames. Overhead is low enough to keep it running.
+        /// Returns false if sampling is already running.
+        /// </summary>
+        /// <param name="intervalBytes">Defaults to 512 KB</param>
+        /// <param name="stackDepth">Defaults to 16</param>
+        /// <returns></returns>
+        public bool StartAllocationSampling(int intervalBytes = 0, int stackDepth = 0)
+        {
+            return V8Context_StartAllocationSampling(context, intervalBytes, stackDepth).GetBooleanValue();
+        }
+
+        /// <summary>
+        /// Stops sampling and saves sampled allocations that are still alive at path as
+        /// .heapprofile, which DevTools can load.
+        /// </summary>
+        /// <param name="path"></param>
+        public void StopAllocationSampling(string path)
+        {
+            V8Context_StopAllocationSampling(context, path).ThrowError();
+        }
+
+        /// <summary>
+        /// Heap, space and handle counts of this context, cheap enough to poll for telemetry.
+        /// Code statistics walk the whole heap, so they are collected only when asked for.
+        /// </summary>
+        /// <param name="includeCodeStatistics"></param>
+        /// <returns></returns>
+        public HeapStatistics GetHeapStatistics(bool includeCodeStatistics = false)
+        {
+            V8Context_GetHeapStatistics(context, out var statistics, includeCodeStatistics).ThrowError();
+            statistics.Spaces = statistics.Spaces.Take(statistics.SpaceCount).ToArray();
+            return statistics;
+        }
+
+        /// <summary>
+        /// Records Chrome trace events of V8 and of every call in and out of this library
+        /// into a JSON trace at path, which chrome://tracing and Perfetto can load. Tracing
+        /// is process wide, it includes all contexts.
+        /// </summary>
+        /// <param name="path"></param>
+        /// <param name="categories">Comma separated categories, default is v8,v8.execute,xv8</param>
+        public void StartTracing(string path, string categories = null)
+        {
+            V8Context_StartTracing(context, categories ?? "", path).ThrowError();
+        }
+
+        /// <summary>
+        /// Stops tracing and finishes the trace file
+        /// </summary>
+        public void StopTracing()
+        {
+            V8Context_StopTracing(context).ThrowError();
+        }
+
+        /// <summary>
+        /// Evaluates script file without loading it in CLR, the file is memory mapped
+        /// and used as a one byte string if it is pure ASCII.
+        /// </summary>
+        /// <param name="path">Path of the script file</param>
+        /// <param name="location">Location displayed in stack trace, defaults to path</param>
+        /// <returns></returns>
+        public IJSValue EvaluateFile(string path, string location = null)
+        {
+            var c = V8Context_EvaluateFile(
+                context,
+                path,
+                location);
+            return new JSValue(this, c);
+        }
+
+        /// <summary>
+        /// Compiles script without running it, if code cache produced by
+        /// <see cref="JSScript.CreateCodeCache"/> in previous launch is passed,
+        /// compilation is skipped for everything in the cache.
+        /// </summary>
+        /// <param name="script"></param>
+        /// <param name="location"></param>
+        /// <param name="codeCache"></param>
+        /// <returns></returns>
+        public JSScript CompileScript(string script, string location = null, byte[] codeCache = null)
+        {
+            location = location ?? "vm";
+            var r = V8Context_CompileScript(
+                context,
+                script,
+                location,
+                codeCache,
+                codeCache?.Length ?? 0);
+            r.ThrowError();
+            return new JSScript(this, r.address, r.result.booleanValue);
+        }
+
+        /// <summary>
+        /// Creates a new realm (v8::Context) inside this context's isolate, realm
+        /// has its own global and security token but shares heap and compilation cache.
+        /// Returned value is the global object of the realm, values can be passed
+        /// between realms without serialization.
+        /// </summary>
+        /// <param name="name">Name displayed in the inspector</param>
+        /// <returns>Global object of the realm</returns>
+        public IJSValue CreateRealm(string name = null)
+        {
+            return new JSValue(this, V8Context_CreateRealm(context, name ?? "realm"));
+        }
+
+        public IJSValue EvaluateInRealm(IJSValue realm, string script, string location = null)
+        {
+            location = location ?? "vm";
+            var c = V8Context_EvaluateInRealm(
+                context,
+                realm.ToHandle(this),
+                script,
+                location);
+            return new JSValue(this, c);
+        }
+
+        public bool DisposeRealm(IJSValue realm)
+        {
+            return V8Context_DisposeRealm(context, realm.ToHandle(this)).GetBooleanValue();
+        }
+
         public IJSValue Wrap(object value)
         {
             var wgc = GCHandle.Alloc(value);
@@ -519,6 +831,167 @@ namespace Xamarin.Android.V8
             return this.Global.DeleteProperty(name);
         }
 
+        /// <summary>
+        /// Moves this context to its own native thread, after this every call to
+        /// the context must be made from <see cref="Post(Action)"/>.
+        /// </summary>
+        /// <param name="stackSizeKb">Stack size of the thread, V8 gets all but 492KB of it</param>
+        public void StartThread(int stackSizeKb = 4096)
+        {
+            V8Context_StartThread(context, stackSizeKb).ThrowError();
+            context.HasThread = true;
+        }
+
+        /// <summary>
+        /// Runs action on the thread that owns this context, it can be called from any thread.
+        /// </summary>
+        /// <param name="action"></param>
+        /// <returns></returns>
+        public Task Post(Action action)
+        {
+            return Post<object>(() => {
+                action();
+                return null;
+            });
+        }
+
+        public Task<T> Post<T>(Func<T> func)
+        {
+            return Schedule(func, false);
+        }
+
+        /// <summary>
+        /// Runs action on the JS thread at the next interrupt check of the running script,
+        /// without ending it, or when a script runs next. It can be called from any thread,
+        /// action may read values but must not run script of this context. Returned task
+        /// is cancelled if context is disposed or returned to the pool before action runs.
+        /// </summary>
+        /// <param name="action"></param>
+        /// <returns></returns>
+        public Task RequestInterrupt(Action action)
+        {
+            return RequestInterrupt<object>(() => {
+                action();
+                return null;
+            });
+        }
+
+        public Task<T> RequestInterrupt<T>(Func<T> func)
+        {
+            return Schedule(func, true);
+        }
+
+        private Task<T> Schedule<T>(Func<T> func, bool interrupt)
+        {
+            var tcs = new TaskCompletionSource<T>(TaskCreationOptions.RunContinuationsAsynchronously);
+            Action<bool> run = (cancelled) => {
+                if (cancelled)
+                {
+                    tcs.TrySetCanceled();
+                    return;
+                }
+                try
+                {
+                    tcs.TrySetResult(func());
+                }
+                catch (Exception ex)
+                {
+                    tcs.TrySetException(ex);
+                }
+            };
+            var g = GCHandle.Alloc(run);
+            var task = Marshal.GetFunctionPointerForDelegate(clrTask);
+            var posted = interrupt
+                ? V8Context_RequestInterrupt(
+                    context,
+                    task,
+                    Marshal.GetFunctionPointerForDelegate(clrCancelTask),
+                    GCHandle.ToIntPtr(g))
+                : V8Context_Post(context, task, GCHandle.ToIntPtr(g));
+            if (!posted.GetBooleanValue())
+            {
+                g.Free();
+                tcs.TrySetException(new ObjectDisposedException(nameof(JSContext)));
+            }
+            return tcs.Task;
+        }
+
+        /// <summary>
+        /// Lets any thread use this context, every call takes v8::Locker for its
+        /// duration so calls from different threads are serialized. Once enabled,
+        /// it cannot be turned off and context cannot be returned to the pool.
+        /// </summary>
+        public void EnableLocking()
+        {
+            V8Context_EnableLocking(context).ThrowError();
+        }
+
+        /// <summary>
+        /// Holds the lock for several calls, returned value must be disposed
+        /// on the same thread, so do not await inside the using block.
+        /// </summary>
+        /// <returns></returns>
+        public IDisposable Lock()
+        {
+            V8Context_Lock(context).ThrowError();
+            return new ContextLock(this);
+        }
+
+        private class ContextLock : IDisposable
+        {
+            private JSContext owner;
+
+            public ContextLock(JSContext owner)
+            {
+                this.owner = owner;
+            }
+
+            public void Dispose()
+            {
+                var c = owner;
+                if (c == null)
+                    return;
+                owner = null;
+                V8Context_Unlock(c.context).ThrowError();
+            }
+        }
+
+        /// <summary>
+        /// With <see cref="MicrotaskPolicy.Explicit"/>, promise reactions are not run after each
+        /// call, host drains them once per batch or frame with <see cref="PerformMicrotaskCheckpoint"/>.
+        /// </summary>
+        /// <param name="policy"></param>
+        public void SetMicrotaskPolicy(MicrotaskPolicy policy)
+        {
+            V8Context_SetMicrotaskPolicy(context, (int)policy).ThrowError();
+        }
+
+        public void PerformMicrotaskCheckpoint()
+        {
+            V8Context_PerformMicrotaskCheckpoint(context).ThrowError();
+        }
+
+        /// <summary>
+        /// Runs foreground tasks V8 has posted for this isolate, such as GC finalization.
+        /// Contexts without their own thread should call this from the host loop,
+        /// contexts started with <see cref="StartThread"/> pump automatically.
+        /// </summary>
+        /// <param name="maxMicros">Time budget, zero runs till the queue is empty</param>
+        /// <returns>Number of tasks run</returns>
+        public int PumpMessageLoop(int maxMicros = 0)
+        {
+            return V8Context_PumpMessageLoop(context, maxMicros).GetIntegerValue();
+        }
+
+        /// <summary>
+        /// Gives V8 idle time, e.g. the rest of a frame, for idle time GC.
+        /// </summary>
+        /// <param name="idleSeconds"></param>
+        public void RunIdleTasks(double idleSeconds)
+        {
+            V8Context_RunIdleTasks(context, idleSeconds).ThrowError();
+        }
+
         public void RunOnUIThread(Func<Task> task)
         {
             MainThread.BeginInvokeOnMainThread(async () => {
@@ -547,6 +1020,32 @@ namespace Xamarin.Android.V8
             CLREnv env
             );
 
+        [DllImport(LibName)]
+        internal extern static V8Handle V8Context_AcquireFromPool(
+            bool debug,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            CLREnv env
+            );
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_GetCallStats();
+
+        [DllImport(LibName)]
+        internal extern static void V8Context_ResetCallStats();
+
+        [DllImport(LibName)]
+        internal extern static void V8Context_Prewarm(
+            int count,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            CLREnv env
+            );
+
+        [DllImport(LibName)]
+        internal extern static void V8Context_SetPoolPolicy(int policy);
+
+        [DllImport(LibName)]
+        internal extern static void V8Context_GetPoolStatistics(out PoolStatistics statistics);
+
         [DllImport(LibName, EntryPoint= nameof(V8Context_Dispose))]
         internal extern static void V8Context_Dispose(V8Handle context);
 
@@ -607,6 +1106,25 @@ namespace Xamarin.Android.V8
             [MarshalAs(UnmanagedType.LPArray)]
             V8Handle[] args);
 
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_InvokeFunctionWithBudget(V8Handle context,
+            V8Handle target,
+            V8Handle thisValue,
+            int len,
+            [MarshalAs(UnmanagedType.LPArray)]
+            V8Handle[] args,
+            int timeoutMs);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_InvokeAsync(V8Handle context,
+            V8Handle target,
+            V8Handle thisValue,
+            int len,
+            [MarshalAs(UnmanagedType.LPArray)]
+            V8Handle[] args,
+            IntPtr completion,
+            IntPtr token);
+
         [DllImport(LibName)]
         internal extern static V8Response V8Context_IsInstanceOf(V8Handle context, V8Handle target, V8Handle jsClass);
 
@@ -698,6 +1216,45 @@ namespace Xamarin.Android.V8
             );
 
 
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StartThread(
+            V8Handle context,
+            int stackSizeKb);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_Post(
+            V8Handle context,
+            IntPtr task,
+            IntPtr data);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_RequestInterrupt(
+            V8Handle context,
+            IntPtr task,
+            IntPtr cancel,
+            IntPtr data);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_SetMicrotaskPolicy(V8Handle context, int policy);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_PerformMicrotaskCheckpoint(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_PumpMessageLoop(V8Handle context, int maxMicros);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_RunIdleTasks(V8Handle context, double idleSeconds);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_EnableLocking(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_Lock(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_Unlock(V8Handle context);
+
         [DllImport(LibName)]
         internal extern static V8Response V8Context_SendDebugMessage(
             V8Handle context,
@@ -705,6 +1262,13 @@ namespace Xamarin.Android.V8
             Utf16Value message
             );
 
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_PushDebugMessage(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value message
+            );
+
         [DllImport(LibName)]
         internal extern static V8Response V8Context_ToString(
             V8Handle context,
@@ -738,6 +1302,130 @@ namespace Xamarin.Android.V8
             [MarshalAs(UnmanagedType.LPStruct)] 
             Utf16Value location);
 
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_EvaluateWithBudget(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value script,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value location,
+            int timeoutMs);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_GetCpuTime(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StartCpuProfile(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value title,
+            int samplingIntervalUs,
+            [MarshalAs(UnmanagedType.I1)]
+            bool callerLineNumbers);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StopCpuProfile(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value title,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value path);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_WriteHeapSnapshot(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value path,
+            [MarshalAs(UnmanagedType.I1)]
+            bool includeClrHandles);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StartAllocationSampling(
+            V8Handle context,
+            int intervalBytes,
+            int depth);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StopAllocationSampling(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value path);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_GetHeapStatistics(
+            V8Handle context,
+            out HeapStatistics statistics,
+            [MarshalAs(UnmanagedType.I1)]
+            bool includeCodeStatistics);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StartTracing(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value categories,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value path);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StopTracing(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_StartInspectorServer(V8Handle context, int port);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_AttachInspector(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_DetachInspector(V8Handle context);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_EvaluateFile(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value path,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value location);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_CompileScript(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value script,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value location,
+            [MarshalAs(UnmanagedType.LPArray)]
+            byte[] cache,
+            int cacheLength);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_RunScript(V8Handle context, IntPtr script);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_ProduceWarmCodeCache(V8Handle context, IntPtr script);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_ReleaseScript(V8Handle context, IntPtr script);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_CreateRealm(
+            V8Handle context,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value name);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_EvaluateInRealm(
+            V8Handle context,
+            IntPtr realm,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value script,
+            [MarshalAs(UnmanagedType.LPStruct)]
+            Utf16Value location);
+
+        [DllImport(LibName)]
+        internal extern static V8Response V8Context_DisposeRealm(
+            V8Handle context,
+            IntPtr realm);
+
         public void Dispose()
         {
             if (context.IsDisposed)
@@ -15,6 +15,17 @@ namespace Xamarin.Android.V8
         }
     }
 
+    /// <summary>
+    /// Thrown when script was stopped before it could finish, e.g. its time budget was over.
+    /// </summary>
+    public class JavaScriptTerminatedException: JavaScriptException
+    {
+        public JavaScriptTerminatedException(): base("Script execution was terminated")
+        {
+
+        }
+    }
+
     internal static class JSExtensions
     {
         public static JSValue ToJSValue(this IJSValue v)
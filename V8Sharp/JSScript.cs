@@ -0,0 +1,90 @@
+﻿using System;
+using System.Linq;
+using WebAtoms;
+using WebAtoms.V8Sharp;
+
+namespace Xamarin.Android.V8
+{
+    /// <summary>
+    /// Script compiled by <see cref="JSContext.CompileScript"/>, it can be run
+    /// many times. Code cache created after the startup path has run includes
+    /// all lazily compiled functions.
+    /// </summary>
+    public class JSScript : IDisposable
+    {
+        readonly JSContext jsContext;
+        readonly V8ContextHandle context;
+        private IntPtr handle;
+
+        internal JSScript(JSContext context, IntPtr handle, bool cacheRejected)
+        {
+            this.jsContext = context;
+            this.context = context.context;
+            this.handle = handle;
+            this.CacheRejected = cacheRejected;
+        }
+
+        /// <summary>
+        /// True if code cache passed to compile was rejected by V8,
+        /// cache should be created again.
+        /// </summary>
+        public bool CacheRejected { get; }
+
+        public IJSValue Run()
+        {
+            return new JSValue(jsContext, JSContext.V8Context_RunScript(context, GetHandle()));
+        }
+
+        /// <summary>
+        /// Creates code cache for this script, call this after app has run through
+        /// its startup path so that functions compiled so far are included.
+        /// </summary>
+        /// <returns></returns>
+        public byte[] CreateCodeCache()
+        {
+            return JSContext.V8Context_ProduceWarmCodeCache(context, GetHandle()).GetByteArray();
+        }
+
+        private IntPtr GetHandle()
+        {
+            if (handle == IntPtr.Zero)
+            {
+                throw new ObjectDisposedException("Script has been disposed");
+            }
+            return handle;
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            if (context.IsDisposed || handle == IntPtr.Zero)
+                return;
+            JSContext.V8Context_ReleaseScript(context, handle);
+            handle = IntPtr.Zero;
+        }
+
+        ~JSScript()
+        {
+            if (context.IsDisposed || handle == IntPtr.Zero)
+            {
+                return;
+            }
+            IntPtr h = handle;
+            handle = IntPtr.Zero;
+            if (context.HasThread)
+            {
+                // posted to the context's thread
+                JSContext.V8Context_ReleaseScript(context, h);
+                return;
+            }
+            MainThread.BeginInvokeOnMainThread(() =>
+            {
+                if (context.IsDisposed)
+                {
+                    return;
+                }
+                JSContext.V8Context_ReleaseScript(context, h);
+            });
+        }
+    }
+}
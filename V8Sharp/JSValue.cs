@@ -2,6 +2,7 @@
 using System.Collections.Generic;
 using System.Linq;
 using System.Runtime.InteropServices;
+using System.Threading.Tasks;
 using WebAtoms;
 using V8Handle = System.IntPtr;
 using WebAtoms.V8Sharp;
@@ -271,8 +272,9 @@ namespace Xamarin.Android.V8
             }
             IntPtr h = handle.address;
             handle.address = IntPtr.Zero;
-            if (MainThread.IsMainThread)
+            if (context.HasThread || MainThread.IsMainThread)
             {
+                // context with its own thread gets the release posted to it
                 JSContext.V8Context_ReleaseHandle(context, h).GetBooleanValue();
             }
             else
@@ -312,6 +314,68 @@ namespace Xamarin.Android.V8
             return new JSValue(jsContext, r);
         }
 
+        /// <summary>
+        /// Invokes function, if it does not return within timeout, it is terminated and
+        /// <see cref="JavaScriptTerminatedException"/> is thrown.
+        /// </summary>
+        /// <param name="timeout"></param>
+        /// <param name="thisValue"></param>
+        /// <param name="args"></param>
+        /// <returns></returns>
+        public IJSValue InvokeFunction(TimeSpan timeout, IJSValue thisValue, params IJSValue[] args)
+        {
+            V8Handle th = IntPtr.Zero;
+            if (thisValue != null)
+            {
+                th = ((JSValue)thisValue).handle.address;
+            }
+            var r = JSContext.V8Context_InvokeFunctionWithBudget(
+                context,
+                handle.address,
+                th,
+                args.Length,
+                args.ToHandles(jsContext),
+                (int)Math.Ceiling(timeout.TotalMilliseconds));
+            return new JSValue(jsContext, r);
+        }
+
+        /// <summary>
+        /// Invokes function, if it returns a promise, task completes when the promise settles,
+        /// rejection is thrown as <see cref="JavaScriptException"/>. Must be called on the thread
+        /// that owns the context, continuation runs there as well.
+        /// </summary>
+        /// <param name="thisValue"></param>
+        /// <param name="args"></param>
+        /// <returns></returns>
+        public Task<IJSValue> InvokeFunctionAsync(IJSValue thisValue, params IJSValue[] args)
+        {
+            V8Handle th = IntPtr.Zero;
+            if (thisValue != null)
+            {
+                th = ((JSValue)thisValue).handle.address;
+            }
+            var tcs = new TaskCompletionSource<IJSValue>();
+            var token = GCHandle.Alloc((jsContext, tcs));
+            var r = JSContext.V8Context_InvokeAsync(
+                context,
+                handle.address,
+                th,
+                args.Length,
+                args.ToHandles(jsContext),
+                Marshal.GetFunctionPointerForDelegate(JSContext.asyncCompletion),
+                GCHandle.ToIntPtr(token));
+            try
+            {
+                r.ThrowError();
+            }
+            catch
+            {
+                token.Free();
+                throw;
+            }
+            return tcs.Task;
+        }
+
         public bool InstanceOf(IJSValue jsClass)
         {
             return JSContext.V8Context_IsInstanceOf(context, handle.address, jsClass.ToHandle(jsContext)).GetBooleanValue();
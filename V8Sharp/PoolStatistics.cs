@@ -0,0 +1,28 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace Xamarin.Android.V8
+{
+    /// <summary>
+    /// State of the context pool filled by Prewarm, counts are since process start.
+    /// Layout must match __PoolStatistics in IsolatePool.h.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PoolStatistics
+    {
+        /// <summary>
+        /// Contexts waiting to be acquired
+        /// </summary>
+        public int Ready;
+
+        /// <summary>
+        /// New JSContext got a context from the pool instead of creating an isolate
+        /// </summary>
+        public int Hits;
+
+        /// <summary>
+        /// Disposed contexts that were reset and returned to the pool
+        /// </summary>
+        public int Recycled;
+    }
+}
@@ -19,6 +19,12 @@ namespace Xamarin.Android.V8
 
         public bool IsDisposed => this.value == IntPtr.Zero;
 
+        /// <summary>
+        /// Context runs on its own native thread, handle and script releases
+        /// from other threads are posted to it by the native side.
+        /// </summary>
+        public bool HasThread { get; set; }
+
         public static implicit operator V8ContextHandle(IntPtr v)
         {
             return new V8ContextHandle { value = v };
@@ -30,6 +30,14 @@ namespace Xamarin.Android.V8
         Error = 0x14,
         ConstError = 0x15,
 
-        ResponseArray = 0x16
+        ResponseArray = 0x16,
+
+        // address is native compiled script
+        CompiledScript = 0x17,
+        // address is allocated with allocateMemory
+        ByteArray = 0x18,
+
+        // execution was terminated, no value
+        Terminated = 0x19
     }
 }
\ No newline at end of file
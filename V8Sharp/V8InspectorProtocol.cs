@@ -18,6 +18,30 @@ namespace Xamarin.Android.V8
 
         public abstract void SendMessage(string message);
 
+        private System.IO.MemoryStream pendingMessage;
+
+        /// <summary>
+        /// Receives UTF-8 message in one or more chunks, endOfMessage is true for the last one.
+        /// Default implementation decodes whole message and calls SendMessage(string).
+        /// </summary>
+        /// <param name="utf8"></param>
+        /// <param name="endOfMessage"></param>
+        public virtual void SendMessage(byte[] utf8, bool endOfMessage)
+        {
+            if (endOfMessage && pendingMessage == null)
+            {
+                SendMessage(Encoding.UTF8.GetString(utf8));
+                return;
+            }
+            pendingMessage = pendingMessage ?? new System.IO.MemoryStream();
+            pendingMessage.Write(utf8, 0, utf8.Length);
+            if (endOfMessage)
+            {
+                SendMessage(Encoding.UTF8.GetString(pendingMessage.GetBuffer(), 0, (int)pendingMessage.Length));
+                pendingMessage = null;
+            }
+        }
+
         public static V8InspectorProtocol CreateWebSocketServer(int port)
         {
             return new V8InspectorProtocolServer(port);
@@ -28,6 +52,17 @@ namespace Xamarin.Android.V8
             return new V8InspectorProtocolProxy(uri);
         }
 
+        /// <summary>
+        /// Inspector served by native code on 127.0.0.1, protocol messages never
+        /// pass through CLR. Use adb forward to connect from development machine.
+        /// </summary>
+        /// <param name="port"></param>
+        /// <returns></returns>
+        public static V8InspectorProtocol CreateNativeServer(int port)
+        {
+            return new V8InspectorProtocolNative(port);
+        }
+
     }
 
     internal class V8InspectorProtocolProxy : V8InspectorProtocol
@@ -98,6 +133,44 @@ namespace Xamarin.Android.V8
                 await client.SendAsync(buffer, System.Net.WebSockets.WebSocketMessageType.Text, true, cancellationTokenSource.Token);
             });
         }
+
+        public override void SendMessage(byte[] utf8, bool endOfMessage)
+        {
+            // chunks go out as fragments of one message, dispatcher keeps their order
+            AtomAsyncDispatcher.Instance.EnqueueTask(async () =>
+            {
+                var buffer = new ArraySegment<byte>(utf8);
+                await client.SendAsync(buffer, System.Net.WebSockets.WebSocketMessageType.Text, endOfMessage, cancellationTokenSource.Token);
+            });
+        }
+    }
+
+    internal class V8InspectorProtocolNative : V8InspectorProtocol
+    {
+        public readonly int Port;
+
+        public V8InspectorProtocolNative(int port)
+        {
+            this.Port = port;
+        }
+
+        // native server is owned and stopped by the context
+        public override void Dispose()
+        {
+        }
+
+        public override Task ConnectAsync(Action<string> onMessageReceived)
+        {
+            return Task.CompletedTask;
+        }
+
+        public override void SendMessage(string message)
+        {
+        }
+
+        public override void SendMessage(byte[] utf8, bool endOfMessage)
+        {
+        }
     }
 
     internal class V8InspectorProtocolServer : V8InspectorProtocol
@@ -186,5 +259,35 @@ namespace Xamarin.Android.V8
                 }
             }
         }
+
+        private readonly List<byte[]> pendingChunks = new List<byte[]>();
+
+        public override void SendMessage(byte[] utf8, bool endOfMessage)
+        {
+            pendingChunks.Add(utf8);
+            if (!endOfMessage)
+                return;
+            var chunks = pendingChunks.ToArray();
+            pendingChunks.Clear();
+            lock (clients)
+            {
+                foreach (var client in clients)
+                {
+                    AtomAsyncDispatcher.Instance.EnqueueTask(() => WriteChunksAsync(client, chunks));
+                }
+            }
+        }
+
+        private static async Task WriteChunksAsync(WebSocket client, byte[][] chunks)
+        {
+            using (var writer = client.CreateMessageWriter(WebSocketMessageType.Text))
+            {
+                foreach (var chunk in chunks)
+                {
+                    await writer.WriteAsync(chunk, 0, chunk.Length);
+                }
+                await writer.CloseAsync();
+            }
+        }
     }
 }
\ No newline at end of file
@@ -49,6 +49,10 @@ namespace Xamarin.Android.V8
                 var msg = r.StringValue;
                 throw new JavaScriptException(msg);
             }
+            if (r.Type == V8HandleType.Terminated)
+            {
+                throw new JavaScriptTerminatedException();
+            }
         }
 
         internal static bool GetBooleanValue(this V8Response r)
@@ -62,6 +66,19 @@ namespace Xamarin.Android.V8
             return r.result.booleanValue;
         }
 
+        internal static byte[] GetByteArray(this V8Response r)
+        {
+            ThrowError(r);
+            if (r.Type != V8HandleType.ByteArray)
+            {
+                throw new NotSupportedException();
+            }
+            var bytes = new byte[r.length];
+            Marshal.Copy(r.address, bytes, 0, r.length);
+            Marshal.FreeHGlobal(r.address);
+            return bytes;
+        }
+
         internal static int GetIntegerValue(this V8Response r)
         {
             ThrowError(r);
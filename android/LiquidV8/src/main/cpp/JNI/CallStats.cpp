@@ -0,0 +1,98 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "CallStats.h"
+
+#include <cstring>
+
+// slots are pushed once and never removed, readers walk the list without lock
+static std::atomic<CallStats::Slot*> slots(nullptr);
+
+#if defined(__aarch64__)
+static uint64_t ReadNanosPerTick() {
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return (static_cast<uint64_t>(1000000000) << 32) / frequency;
+}
+
+uint64_t CallStats::nanosPerTick = ReadNanosPerTick();
+#elif defined(__x86_64__)
+// TSC frequency is not exposed, measured against steady clock at load
+static uint64_t ReadNanosPerTick() {
+#ifdef XV8_CALL_STATS
+    auto start = std::chrono::steady_clock::now();
+    uint64_t ticks = __rdtsc();
+    std::chrono::nanoseconds elapsed;
+    do {
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 2000000);
+    ticks = __rdtsc() - ticks;
+    return (static_cast<uint64_t>(elapsed.count()) << 32) / ticks;
+#else
+    return 1;
+#endif
+}
+
+uint64_t CallStats::nanosPerTick = ReadNanosPerTick();
+#endif
+
+CallStats::Slot* CallStats::Register(const char* name) {
+    Slot* slot = new Slot();
+    slot->name = name;
+    slot->nanos.store(0, std::memory_order_relaxed);
+    for (auto &h : slot->histogram) {
+        h.store(0, std::memory_order_relaxed);
+    }
+    Slot* head = slots.load(std::memory_order_relaxed);
+    do {
+        slot->next = head;
+    } while (!slots.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+    return slot;
+}
+
+void CallStats::Reset() {
+    for (Slot* s = slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+        s->nanos.store(0, std::memory_order_relaxed);
+        for (auto &h : s->histogram) {
+            h.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+static void Put(std::string &out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+std::string CallStats::Snapshot() {
+    std::string out;
+#ifdef XV8_CALL_STATS
+    Put<int32_t>(out, 1);
+#else
+    Put<int32_t>(out, 0);
+#endif
+    Put<int32_t>(out, kBuckets);
+    size_t countAt = out.size();
+    Put<int32_t>(out, 0);
+    int32_t n = 0;
+    for (Slot* s = slots.load(std::memory_order_acquire); s != nullptr; s = s->next) {
+        int32_t length = static_cast<int32_t>(strlen(s->name));
+        Put<int32_t>(out, length);
+        out.append(s->name, static_cast<size_t>(length));
+        uint64_t histogram[kBuckets];
+        uint64_t count = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            histogram[i] = s->histogram[i].load(std::memory_order_relaxed);
+            count += histogram[i];
+        }
+        Put<int64_t>(out, static_cast<int64_t>(count));
+        Put<int64_t>(out, static_cast<int64_t>(s->nanos.load(std::memory_order_relaxed)));
+        for (uint64_t h : histogram) {
+            Put<int64_t>(out, static_cast<int64_t>(h));
+        }
+        n++;
+    }
+    memcpy(&out[countAt], &n, sizeof(n));
+    return out;
+}
@@ -0,0 +1,112 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_CALLSTATS_H
+#define ANDROID_CALLSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Opt-in per export counters, build with -DXV8_CALL_STATS=1. Every export
+ * that casts its context gets a slot on first call, then each call adds
+ * its nanoseconds and a log2 latency bucket with relaxed atomics.
+ * Compiled out, CALL_STATS_SCOPE is empty and snapshot has no slots.
+ * **/
+namespace CallStats {
+
+    // bucket 0 is below 1ns, bucket n is [2^(n-1), 2^n) ns, last one is open
+    static const int kBuckets = 32;
+
+    struct Slot {
+        const char* name;
+        // call count is the sum of histogram, one atomic less per call
+        std::atomic<uint64_t> nanos;
+        std::atomic<uint64_t> histogram[kBuckets];
+        Slot* next;
+    };
+
+    // returns a slot that lives for the process, called once per export
+    Slot* Register(const char* name);
+
+    // zeroes every counter, calls in flight may still add to them
+    void Reset();
+
+    /**
+     * Packed little endian snapshot: int32 enabled, int32 kBuckets, int32
+     * slot count, then per slot int32 name length, ASCII name, int64 count,
+     * int64 nanos and kBuckets int64 histogram entries.
+     * **/
+    std::string Snapshot();
+
+#if defined(__aarch64__) || defined(__x86_64__)
+    // counter readable from user space, much cheaper than clock_gettime
+    inline uint64_t Now() {
+#if defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return __rdtsc();
+#endif
+    }
+
+    // 32.32 fixed point nanoseconds per tick
+    extern uint64_t nanosPerTick;
+
+    inline uint64_t ToNanos(uint64_t ticks) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * nanosPerTick) >> 32);
+    }
+#else
+    inline uint64_t Now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    inline uint64_t ToNanos(uint64_t ticks) {
+        return ticks;
+    }
+#endif
+
+    inline void Record(Slot* slot, uint64_t nanos) {
+        int bucket = nanos == 0 ? 0 : 64 - __builtin_clzll(nanos);
+        if (bucket >= kBuckets) {
+            bucket = kBuckets - 1;
+        }
+        slot->nanos.fetch_add(nanos, std::memory_order_relaxed);
+        slot->histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    class Scope {
+    public:
+        explicit Scope(Slot* slot): _slot(slot), _start(Now()) {
+        }
+
+        ~Scope() {
+            Record(_slot, ToNanos(Now() - _start));
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Slot* _slot;
+        uint64_t _start;
+    };
+}
+
+#ifdef XV8_CALL_STATS
+#define CALL_STATS_SCOPE \
+    static CallStats::Slot* callStatsSlot = CallStats::Register(__func__); \
+    CallStats::Scope callStatsScope(callStatsSlot);
+#else
+#define CALL_STATS_SCOPE
+#endif
+
+#endif //ANDROID_CALLSTATS_H
@@ -0,0 +1,114 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_DEBUGMESSAGEQUEUE_H
+#define ANDROID_DEBUGMESSAGEQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/**
+ * Inspector protocol messages on their way to the JS thread. Transport
+ * pushes from any thread, only the JS thread pops, either while paused
+ * in debugger or from a drain task posted on context's loop.
+ * Ring is bounded, a producer waits while it is full.
+ * **/
+class DebugMessageQueue {
+public:
+    static const size_t kCapacity = 256;
+
+    DebugMessageQueue() = default;
+
+    DebugMessageQueue(const DebugMessageQueue&) = delete;
+    DebugMessageQueue& operator=(const DebugMessageQueue&) = delete;
+
+    /**
+     * Copies the message, returns false once queue is closed.
+     * wasEmpty tells producer that no drain is pending for the queue.
+     * Never call this on the JS thread, when queue is full it waits for
+     * the JS thread to pop and would deadlock.
+     * **/
+    bool Push(const uint16_t* text, int length, bool &wasEmpty) {
+        std::unique_lock<std::mutex> lock(_lock);
+        while (!_closed && _count == kCapacity) {
+            _notFull.wait(lock);
+        }
+        if (_closed) {
+            return false;
+        }
+        wasEmpty = _count == 0;
+        _ring[(_head + _count) % kCapacity].assign(
+                reinterpret_cast<const char16_t*>(text),
+                static_cast<size_t>(length));
+        _count++;
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    // waits up to timeout for a message, zero does not wait
+    bool Pop(std::u16string &message, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (_count == 0 && !_closed && timeout.count() > 0) {
+            _notEmpty.wait_for(lock, timeout, [this] { return _count > 0 || _closed; });
+        }
+        if (_count == 0) {
+            return false;
+        }
+        message.swap(_ring[_head]);
+        _ring[_head].clear();
+        _head = (_head + 1) % kCapacity;
+        _count--;
+        _notFull.notify_one();
+        return true;
+    }
+
+    // drops pending messages, used when context goes back to pool
+    void Clear() {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (size_t i = 0; i < _count; i++) {
+            _ring[(_head + i) % kCapacity].clear();
+        }
+        _head = 0;
+        _count = 0;
+        _notFull.notify_all();
+    }
+
+    // wakes every waiting thread, nothing can be pushed after this
+    void Close() {
+        std::lock_guard<std::mutex> lock(_lock);
+        _closed = true;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+    // drops pending messages and accepts pushes again
+    void Reopen() {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (size_t i = 0; i < _count; i++) {
+            _ring[(_head + i) % kCapacity].clear();
+        }
+        _head = 0;
+        _count = 0;
+        _closed = false;
+    }
+
+    bool IsClosed() {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _closed;
+    }
+
+private:
+    std::mutex _lock;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::u16string _ring[kCapacity];
+    size_t _head = 0;
+    size_t _count = 0;
+    bool _closed = false;
+};
+
+#endif //ANDROID_DEBUGMESSAGEQUEUE_H
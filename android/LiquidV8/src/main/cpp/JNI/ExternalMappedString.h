@@ -0,0 +1,113 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_EXTERNALMAPPEDSTRING_H
+#define ANDROID_EXTERNALMAPPEDSTRING_H
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cstring>
+
+#include "common.h"
+
+/**
+ * Script source backed by a read only memory mapped file, V8 releases
+ * the mapping when compiled script (and its source) is collected.
+ * **/
+class ExternalMappedString : public v8::String::ExternalOneByteStringResource {
+private:
+    void* _mapping;
+    size_t _mappingLength;
+    const char* _data;
+    size_t _len;
+
+    ExternalMappedString(void* mapping, size_t mappingLength):
+        _mapping(mapping),
+        _mappingLength(mappingLength),
+        _data(static_cast<const char*>(mapping)),
+        _len(mappingLength)
+    {
+        // skip UTF-8 byte order mark
+        if (_len >= 3
+            && (uint8_t)_data[0] == 0xEF
+            && (uint8_t)_data[1] == 0xBB
+            && (uint8_t)_data[2] == 0xBF) {
+            _data += 3;
+            _len -= 3;
+        }
+    }
+
+public:
+
+    /**
+     * Returns nullptr if file could not be opened or mapped, or if it is
+     * empty, empty is set in that case as zero length can not be mapped.
+     * **/
+    static ExternalMappedString* Open(const char* path, bool &empty) {
+        empty = false;
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return nullptr;
+        }
+        struct stat st = {};
+        if (fstat(fd, &st) == -1) {
+            close(fd);
+            return nullptr;
+        }
+        if (st.st_size == 0) {
+            close(fd);
+            empty = true;
+            return nullptr;
+        }
+        size_t length = static_cast<size_t>(st.st_size);
+        void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping stays valid after descriptor is closed
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+        return new ExternalMappedString(mapping, length);
+    }
+
+    ~ExternalMappedString() override {
+        munmap(_mapping, _mappingLength);
+    }
+
+    /**
+     * UTF-8 file can be used as one byte string only if it is pure ASCII,
+     * scans a word at a time.
+     * **/
+    bool IsAscii() const {
+        const char* p = _data;
+        const char* end = _data + _len;
+        const uint64_t mask = 0x8080808080808080ULL;
+        while (p + sizeof(uint64_t) <= end) {
+            uint64_t w;
+            memcpy(&w, p, sizeof(w));
+            if (w & mask) {
+                return false;
+            }
+            p += sizeof(uint64_t);
+        }
+        while (p < end) {
+            if ((uint8_t)*p & 0x80) {
+                return false;
+            }
+            p++;
+        }
+        return true;
+    }
+
+    virtual const char* data() const override {
+        return _data;
+    }
+
+    virtual size_t length() const override {
+        return _len;
+    }
+};
+
+#endif //ANDROID_EXTERNALMAPPEDSTRING_H
@@ -0,0 +1,109 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_EXTERNALX8STRING_H
+#define ANDROID_EXTERNALX8STRING_H
+
+#include <cstdlib>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "common.h"
+
+/**
+ * Returns true if every UTF-16 code unit is below 0x100, so the
+ * text can be stored as a V8 one byte string.
+ * **/
+static inline bool IsLatin1(const uint16_t* data, size_t length) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i high = _mm_set1_epi16((short)0xFF00);
+    for (; i + 32 <= length; i += 32) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(data + i + 8));
+        __m128i c = _mm_loadu_si128((const __m128i*)(data + i + 16));
+        __m128i d = _mm_loadu_si128((const __m128i*)(data + i + 24));
+        __m128i all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        __m128i h = _mm_and_si128(all, high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(h, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 32 <= length; i += 32) {
+        uint16x8_t a = vld1q_u16(data + i);
+        uint16x8_t b = vld1q_u16(data + i + 8);
+        uint16x8_t c = vld1q_u16(data + i + 16);
+        uint16x8_t d = vld1q_u16(data + i + 24);
+        uint16x8_t all = vorrq_u16(vorrq_u16(a, b), vorrq_u16(c, d));
+        // high bytes of every lane
+        uint8x8_t h = vshrn_n_u16(all, 8);
+        if (vget_lane_u64(vreinterpret_u64_u8(h), 0) != 0) {
+            return false;
+        }
+    }
+#endif
+    uint16_t rest = 0;
+    for (; i < length; i++) {
+        rest |= data[i];
+    }
+    return rest < 0x100;
+}
+
+/**
+ * Copies Latin-1 only UTF-16 text into one byte buffer.
+ * **/
+static inline void NarrowLatin1(const uint16_t* source, uint8_t* target, size_t length) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(source + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(source + i + 8));
+        _mm_storeu_si128((__m128i*)(target + i), _mm_packus_epi16(a, b));
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    for (; i + 8 <= length; i += 8) {
+        vst1_u8(target + i, vmovn_u16(vld1q_u16(source + i)));
+    }
+#endif
+    for (; i < length; i++) {
+        target[i] = static_cast<uint8_t>(source[i]);
+    }
+}
+
+/**
+ * One byte copy of a CLR string, CLR string is released as soon as
+ * this is created, buffer is released when V8 collects the string.
+ * **/
+class ExternalX8String : public v8::String::ExternalOneByteStringResource {
+private:
+    char* _data;
+    const size_t _len;
+public:
+
+    ExternalX8String(const uint16_t* d, size_t len):
+        _data(static_cast<char*>(malloc(len))),
+        _len(len)
+    {
+        NarrowLatin1(d, reinterpret_cast<uint8_t*>(_data), len);
+    }
+
+    ~ExternalX8String() override {
+        free(_data);
+    }
+
+    virtual const char* data() const override {
+        return _data;
+    }
+
+    virtual size_t length() const override {
+        return _len;
+    }
+};
+
+#endif //ANDROID_EXTERNALX8STRING_H
@@ -10,13 +10,17 @@
 #include "common.h"
 #include "v8-inspector.h"
 #include "V8Context.h"
+#include "InspectorServer.h"
+#include "Utf8.h"
+#include <algorithm>
 
 const int kInspectorClientIndex = v8::Context::kDebugIdIndex + 1;
 
 class InspectorFrontend final : public v8_inspector::V8Inspector::Channel {
 public:
-    explicit InspectorFrontend(V8Context* c, SendDebugMessage sendDebugMessage) {
-        sendDebugMessage_ = sendDebugMessage;
+    explicit InspectorFrontend(V8Context* c, ClrEnv env) {
+        sendDebugMessage_ = env->sendDebugMessage;
+        sendDebugMessageUtf8_ = env->sendDebugMessageUtf8;
         isolate_ = c->GetIsolate();
         vc = c;
     }
@@ -39,6 +43,15 @@ private:
     }
 
     void Send(int callId, const v8_inspector::StringView& string) {
+        InspectorServer* server = vc->GetInspectorServer();
+        if (server != nullptr) {
+            server->Send(string);
+            return;
+        }
+        if (sendDebugMessageUtf8_ != nullptr) {
+            SendUtf8(string);
+            return;
+        }
         if (string.is8Bit()) {
             sendDebugMessage_(string.length(), string.characters8(), nullptr);
         } else {
@@ -46,9 +59,39 @@ private:
         }
     }
 
+    /**
+     * Transcodes into buffer_ which is reused for every message, snapshots
+     * and profiles are sent in chunks so buffer stays bounded.
+     * **/
+    void SendUtf8(const v8_inspector::StringView& string) {
+        size_t length = string.length();
+        size_t start = 0;
+        do {
+            size_t end = std::min(length, start + kUtf8ChunkLength);
+            buffer_.clear();
+            if (string.is8Bit()) {
+                Utf8::Append(buffer_, string.characters8() + start, end - start);
+            } else {
+                const uint16_t* text = string.characters16();
+                // surrogate pair is never split between chunks
+                if (end < length && text[end - 1] >= 0xD800 && text[end - 1] <= 0xDBFF) {
+                    end--;
+                }
+                Utf8::Append(buffer_, text + start, end - start);
+            }
+            sendDebugMessageUtf8_(buffer_.data(), static_cast<int>(buffer_.size()), end == length);
+            start = end;
+        } while (start < length);
+    }
+
+    // code units transcoded per chunk, at most three bytes each
+    static const size_t kUtf8ChunkLength = 64 * 1024;
+
     Isolate* isolate_;
     V8Context* vc;
     SendDebugMessage sendDebugMessage_;
+    SendDebugMessageUtf8 sendDebugMessageUtf8_;
+    std::string buffer_;
 };
 
 class XV8InspectorClient : public v8_inspector::V8InspectorClient {
@@ -61,12 +104,10 @@ public:
     :v8_inspector::V8InspectorClient()
     {
         if (!connect) return;
-        freeMemory = env->freeHandle;
-        readDebugMessage_ = env->readDebugMessage;
-        breakPauseOn_ = env->breakPauseOn;
+        messages_ = vc->GetDebugMessages();
         platform_ = platform;
         isolate_ = vc->GetIsolate();
-        channel_.reset(new InspectorFrontend(vc, env->sendDebugMessage));
+        channel_.reset(new InspectorFrontend(vc, env));
         inspector_ = v8_inspector::V8Inspector::create(isolate_, this);
         session_ =
                 inspector_->connect(1, channel_.get(), v8_inspector::StringView());
@@ -77,6 +118,17 @@ public:
         context_.Reset(isolate_, context);
     }
 
+    ~XV8InspectorClient() override {
+        if (context_.IsEmpty()) {
+            return;
+        }
+        // session and inspector are released before context forgets client
+        session_.reset();
+        inspector_.reset();
+        context_.Get(isolate_)->SetAlignedPointerInEmbedderData(kInspectorClientIndex, nullptr);
+        context_.Reset();
+    }
+
     void runMessageLoopOnPause(int context_group_id) override
     {
         if (running_nested_loop_) {
@@ -86,15 +138,17 @@ public:
 
 
         terminated_ = false;
-        breakPauseOn_(true);
         running_nested_loop_ = true;
-        while (!terminated_) {
-            auto dm = readDebugMessage_();
-            v8_inspector::StringView message_view(dm.Value, dm.Length);
-            session_->dispatchProtocolMessage(message_view);
+        std::u16string message;
+        while (!terminated_ && !messages_->IsClosed()) {
+            // platform tasks are pumped at least this often while paused
+            if (messages_->Pop(message, std::chrono::milliseconds(kPauseWaitMillis))) {
+                v8_inspector::StringView message_view(
+                        reinterpret_cast<const uint16_t*>(message.data()),
+                        message.length());
+                session_->dispatchProtocolMessage(message_view);
+            }
             while (v8::platform::PumpMessageLoop(platform_, isolate_)) {}
-            freeMemory(dm.Handle);
-
         }
 
         terminated_ = false;
@@ -103,13 +157,26 @@ public:
 
     void quitMessageLoopOnPause() override {
         terminated_ = true;
-        breakPauseOn_(false);
+    }
+
+    inline bool IsPaused() const {
+        return running_nested_loop_;
     }
 
     inline void SendDebugMessage(v8_inspector::StringView &messageView) {
         session_->dispatchProtocolMessage(messageView);
     }
 
+    // realms are reported as separate contexts in the same group
+    inline void ContextCreated(Local<Context> context, v8_inspector::StringView &name) {
+        inspector_->contextCreated(v8_inspector::V8ContextInfo(
+                context, kContextGroupId, name));
+    }
+
+    inline void ContextDestroyed(Local<Context> context) {
+        inspector_->contextDestroyed(context);
+    }
+
 
 private:
 
@@ -120,6 +187,7 @@ private:
     }
 
     static const int kContextGroupId = 1;
+    static const int kPauseWaitMillis = 10;
 
     std::unique_ptr<v8_inspector::V8Inspector> inspector_;
     std::unique_ptr<v8_inspector::V8InspectorSession> session_;
@@ -127,11 +195,9 @@ private:
     Global<Context> context_;
     Isolate* isolate_;
     v8::Platform* platform_;
-    bool running_nested_loop_;
-    bool terminated_;
-    ReadDebugMessage readDebugMessage_;
-    BreakPauseOn  breakPauseOn_;
-    FreeMemory freeMemory;
+    bool running_nested_loop_ = false;
+    bool terminated_ = false;
+    DebugMessageQueue* messages_ = nullptr;
 };
 
 #endif //ANDROID_INSPECTORCHANNEL_H
@@ -0,0 +1,504 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "InspectorServer.h"
+#include "V8Context.h"
+#include "Utf8.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+// largest frame header, 2 bytes + 64 bit length
+static const size_t kMaxHeader = 10;
+// protocol messages larger than this close the connection
+static const size_t kMaxMessage = 256 * 1024 * 1024;
+static const size_t kMaxRequest = 8 * 1024;
+static const int kRequestTimeoutSeconds = 2;
+// Send runs on JS thread, a client that stops reading is dropped after this
+static const int kSendTimeoutSeconds = 5;
+
+static const uint8_t kOpContinuation = 0x0;
+static const uint8_t kOpText = 0x1;
+static const uint8_t kOpBinary = 0x2;
+static const uint8_t kOpClose = 0x8;
+static const uint8_t kOpPing = 0x9;
+static const uint8_t kOpPong = 0xA;
+
+static const char* kWebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+static inline uint32_t RotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// only used for Sec-WebSocket-Accept
+static void Sha1(const std::string &input, uint8_t digest[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    std::string data = input;
+    uint64_t bitLength = static_cast<uint64_t>(input.size()) * 8;
+    data.push_back(static_cast<char>(0x80));
+    while (data.size() % 64 != 56) {
+        data.push_back('\0');
+    }
+    for (int i = 7; i >= 0; i--) {
+        data.push_back(static_cast<char>((bitLength >> (i * 8)) & 0xFF));
+    }
+    for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+        uint32_t w[80];
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(data.data() + chunk);
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t(p[i * 4]) << 24) | (uint32_t(p[i * 4 + 1]) << 16)
+                    | (uint32_t(p[i * 4 + 2]) << 8) | uint32_t(p[i * 4 + 3]);
+        }
+        for (int i = 16; i < 80; i++) {
+            w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = RotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = RotateLeft(b, 30);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    for (int i = 0; i < 5; i++) {
+        digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+}
+
+static std::string Base64(const uint8_t* data, size_t length) {
+    static const char* kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < length; i += 3) {
+        uint32_t n = uint32_t(data[i]) << 16;
+        if (i + 1 < length) n |= uint32_t(data[i + 1]) << 8;
+        if (i + 2 < length) n |= uint32_t(data[i + 2]);
+        out.push_back(kAlphabet[(n >> 18) & 0x3F]);
+        out.push_back(kAlphabet[(n >> 12) & 0x3F]);
+        out.push_back(i + 1 < length ? kAlphabet[(n >> 6) & 0x3F] : '=');
+        out.push_back(i + 2 < length ? kAlphabet[n & 0x3F] : '=');
+    }
+    return out;
+}
+
+static std::string ToLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](char c) {
+        return static_cast<char>(c >= 'A' && c <= 'Z' ? c + 32 : c);
+    });
+    return text;
+}
+
+static std::string Trim(const std::string &text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(start, end - start + 1);
+}
+
+static size_t HeaderLength(size_t payloadLength) {
+    return payloadLength < 126 ? 2 : (payloadLength <= 0xFFFF ? 4 : 10);
+}
+
+// server frames are never masked
+static void WriteHeader(char* out, uint8_t opcode, size_t payloadLength) {
+    out[0] = static_cast<char>(0x80 | opcode);
+    if (payloadLength < 126) {
+        out[1] = static_cast<char>(payloadLength);
+    } else if (payloadLength <= 0xFFFF) {
+        out[1] = 126;
+        out[2] = static_cast<char>(payloadLength >> 8);
+        out[3] = static_cast<char>(payloadLength);
+    } else {
+        out[1] = 127;
+        for (int i = 0; i < 8; i++) {
+            out[2 + i] = static_cast<char>((static_cast<uint64_t>(payloadLength) >> ((7 - i) * 8)) & 0xFF);
+        }
+    }
+}
+
+InspectorServer::InspectorServer(V8Context* context, int port):
+    _context(context),
+    _port(port) {
+    char id[32];
+    snprintf(id, sizeof(id), "xv8-%d-%d", static_cast<int>(getpid()), port);
+    _id = id;
+}
+
+InspectorServer::~InspectorServer() {
+    Stop();
+}
+
+bool InspectorServer::Start() {
+    _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_listenFd < 0) {
+        return false;
+    }
+    int on = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(_port));
+    // never reachable from network, use adb forward on device
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(_listenFd, 4) != 0
+        || pipe(_wakeFds) != 0) {
+        close(_listenFd);
+        _listenFd = -1;
+        return false;
+    }
+    if (pthread_create(&_thread, nullptr, &InspectorServer::ThreadMain, this) != 0) {
+        close(_listenFd);
+        close(_wakeFds[0]);
+        close(_wakeFds[1]);
+        _listenFd = -1;
+        return false;
+    }
+    _started = true;
+    return true;
+}
+
+void InspectorServer::Stop() {
+    if (!_started) {
+        return;
+    }
+    _started = false;
+    char c = 0;
+    while (write(_wakeFds[1], &c, 1) < 0 && errno == EINTR) {}
+    pthread_join(_thread, nullptr);
+    close(_wakeFds[0]);
+    close(_wakeFds[1]);
+    close(_listenFd);
+    _listenFd = -1;
+}
+
+void* InspectorServer::ThreadMain(void* data) {
+    static_cast<InspectorServer*>(data)->Run();
+    return nullptr;
+}
+
+void InspectorServer::Run() {
+    while (true) {
+        pollfd fds[3] = {
+            { _wakeFds[0], POLLIN, 0 },
+            { _listenFd, POLLIN, 0 },
+            { _clientFd, POLLIN, 0 }
+        };
+        nfds_t n = _clientFd >= 0 ? 3 : 2;
+        if (poll(fds, n, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[0].revents != 0) {
+            break;
+        }
+        if (fds[1].revents & POLLIN) {
+            Accept();
+        }
+        if (n == 3 && fds[2].revents != 0 && !ReadFrames()) {
+            CloseClient();
+        }
+    }
+    CloseClient();
+}
+
+void InspectorServer::Accept() {
+    int fd = accept(_listenFd, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+    // a stalled request must not block the session
+    timeval timeout = { kRequestTimeoutSeconds, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    if (!HandleHttp(fd)) {
+        close(fd);
+    }
+}
+
+bool InspectorServer::HandleHttp(int fd) {
+    std::string request;
+    size_t end;
+    char buffer[1024];
+    while ((end = request.find("\r\n\r\n")) == std::string::npos) {
+        if (request.size() > kMaxRequest) {
+            return false;
+        }
+        ssize_t r = recv(fd, buffer, sizeof(buffer), 0);
+        if (r <= 0) {
+            return false;
+        }
+        request.append(buffer, static_cast<size_t>(r));
+    }
+
+    size_t lineEnd = request.find("\r\n");
+    std::string line = request.substr(0, lineEnd);
+    size_t s1 = line.find(' ');
+    size_t s2 = line.find(' ', s1 + 1);
+    if (s1 == std::string::npos || s2 == std::string::npos) {
+        return false;
+    }
+    std::string path = line.substr(s1 + 1, s2 - s1 - 1);
+    std::string upgrade;
+    std::string key;
+    size_t pos = lineEnd + 2;
+    while (pos < end) {
+        size_t next = request.find("\r\n", pos);
+        std::string header = request.substr(pos, next - pos);
+        pos = next + 2;
+        size_t colon = header.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string name = ToLower(Trim(header.substr(0, colon)));
+        std::string value = Trim(header.substr(colon + 1));
+        if (name == "upgrade") {
+            upgrade = ToLower(value);
+        } else if (name == "sec-websocket-key") {
+            key = value;
+        }
+    }
+
+    if (upgrade == "websocket" && !key.empty()) {
+        uint8_t digest[20];
+        Sha1(key + kWebSocketGuid, digest);
+        std::string response =
+                "HTTP/1.1 101 Switching Protocols\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: Upgrade\r\n"
+                "Sec-WebSocket-Accept: " + Base64(digest, sizeof(digest)) + "\r\n\r\n";
+        if (!WriteAll(fd, response.data(), response.size())) {
+            return false;
+        }
+        timeval none = { 0, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &none, sizeof(none));
+        timeval sendTimeout = { kSendTimeoutSeconds, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        CloseClient();
+        {
+            std::lock_guard<std::mutex> lock(_sendLock);
+            _clientFd = fd;
+        }
+        // client may have sent its first frame with the request, poll
+        // would not report it as it is already read from the socket
+        _input = request.substr(end + 4);
+        _message.clear();
+        if (!_input.empty() && !ParseFrames()) {
+            CloseClient();
+        }
+        return true;
+    }
+
+    if (path == "/json" || path == "/json/list") {
+        WriteHttp(fd, "200 OK", "application/json; charset=UTF-8", TargetList());
+    } else if (path == "/json/version") {
+        std::string body = "{\n  \"Browser\": \"xv8/";
+        body += V8::GetVersion();
+        body += "\",\n  \"Protocol-Version\": \"1.3\"\n}\n";
+        WriteHttp(fd, "200 OK", "application/json; charset=UTF-8", body);
+    } else {
+        WriteHttp(fd, "404 Not Found", "text/plain", "Not found\n");
+    }
+    return false;
+}
+
+std::string InspectorServer::TargetList() {
+    std::string address = "127.0.0.1:" + std::to_string(_port) + "/" + _id;
+    return "[ {\n"
+           "  \"description\": \"xv8 instance\",\n"
+           "  \"devtoolsFrontendUrl\": \"devtools://devtools/bundled/js_app.html?experiments=true&v8only=true&ws=" + address + "\",\n"
+           "  \"id\": \"" + _id + "\",\n"
+           "  \"title\": \"xv8\",\n"
+           "  \"type\": \"node\",\n"
+           "  \"url\": \"file://\",\n"
+           "  \"webSocketDebuggerUrl\": \"ws://" + address + "\"\n"
+           "} ]\n";
+}
+
+void InspectorServer::WriteHttp(int fd, const char* status, const char* contentType, const std::string &body) {
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: " + std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+    WriteAll(fd, response.data(), response.size());
+}
+
+bool InspectorServer::WriteAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t r = send(fd, data, length, MSG_NOSIGNAL);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += r;
+        length -= static_cast<size_t>(r);
+    }
+    return true;
+}
+
+void InspectorServer::WriteFrame(int fd, uint8_t opcode, const char* payload, size_t length) {
+    char frame[kMaxHeader + 125];
+    size_t header = HeaderLength(length);
+    WriteHeader(frame, opcode, length);
+    memcpy(frame + header, payload, length);
+    std::lock_guard<std::mutex> lock(_sendLock);
+    WriteAll(fd, frame, header + length);
+}
+
+void InspectorServer::Send(const v8_inspector::StringView &message) {
+    std::lock_guard<std::mutex> lock(_sendLock);
+    if (_clientFd < 0) {
+        return;
+    }
+    // payload is encoded after room for the largest header
+    _frame.assign(kMaxHeader, '\0');
+    if (message.is8Bit()) {
+        Utf8::Append(_frame, message.characters8(), message.length());
+    } else {
+        Utf8::Append(_frame, message.characters16(), message.length());
+    }
+    size_t length = _frame.size() - kMaxHeader;
+    size_t header = HeaderLength(length);
+    char* start = &_frame[kMaxHeader - header];
+    WriteHeader(start, kOpText, length);
+    if (!WriteAll(_clientFd, start, header + length)) {
+        // failed or timed out, server thread sees the hang up and closes the client
+        shutdown(_clientFd, SHUT_RDWR);
+    }
+    if (_frame.capacity() > 1024 * 1024) {
+        // keep the buffer only for usual message sizes
+        std::string().swap(_frame);
+    }
+}
+
+bool InspectorServer::ReadFrames() {
+    char buffer[16 * 1024];
+    ssize_t r = recv(_clientFd, buffer, sizeof(buffer), 0);
+    if (r <= 0) {
+        return r < 0 && errno == EINTR;
+    }
+    _input.append(buffer, static_cast<size_t>(r));
+    return ParseFrames();
+}
+
+bool InspectorServer::ParseFrames() {
+    size_t pos = 0;
+    while (_input.size() - pos >= 2) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(_input.data() + pos);
+        size_t available = _input.size() - pos;
+        bool fin = (p[0] & 0x80) != 0;
+        uint8_t opcode = p[0] & 0x0F;
+        bool masked = (p[1] & 0x80) != 0;
+        uint64_t length = p[1] & 0x7F;
+        size_t header = 2;
+        if (!masked) {
+            // clients must mask every frame
+            return false;
+        }
+        if (length == 126) {
+            if (available < 4) break;
+            length = (uint64_t(p[2]) << 8) | p[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; i++) {
+                length = (length << 8) | p[2 + i];
+            }
+            header = 10;
+        }
+        if (length > kMaxMessage || _message.size() + length > kMaxMessage) {
+            return false;
+        }
+        header += 4;
+        if (available < header + length) {
+            break;
+        }
+        const uint8_t* mask = p + header - 4;
+        char* payload = &_input[pos + header];
+        for (uint64_t i = 0; i < length; i++) {
+            payload[i] ^= mask[i & 3];
+        }
+        size_t size = static_cast<size_t>(length);
+        pos += header + size;
+
+        switch (opcode) {
+            case kOpContinuation:
+            case kOpText:
+            case kOpBinary:
+                _message.append(payload, size);
+                if (fin) {
+                    Utf8::ToUtf16(_message.data(), _message.size(), _message16);
+                    _context->QueueDebugMessage(
+                            reinterpret_cast<const uint16_t*>(_message16.data()),
+                            static_cast<int>(_message16.size()));
+                    _message.clear();
+                }
+                break;
+            case kOpClose:
+                WriteFrame(_clientFd, kOpClose, payload, std::min<size_t>(size, 2));
+                return false;
+            case kOpPing:
+                WriteFrame(_clientFd, kOpPong, payload, std::min<size_t>(size, 125));
+                break;
+            default:
+                break;
+        }
+    }
+    _input.erase(0, pos);
+    return true;
+}
+
+void InspectorServer::CloseClient() {
+    std::lock_guard<std::mutex> lock(_sendLock);
+    if (_clientFd >= 0) {
+        close(_clientFd);
+        _clientFd = -1;
+    }
+    _input.clear();
+    _message.clear();
+}
@@ -0,0 +1,83 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_INSPECTORSERVER_H
+#define ANDROID_INSPECTORSERVER_H
+
+#include <pthread.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "v8-inspector.h"
+
+class V8Context;
+
+/**
+ * DevTools endpoint on 127.0.0.1 served from its own thread, `/json` lists
+ * the context and a WebSocket upgrade connects to its inspector session.
+ * Incoming messages go straight into context's debug message queue and
+ * outgoing ones are written to the socket on the JS thread, CLR is not
+ * involved. One client at a time, new connection replaces the old one.
+ * **/
+class InspectorServer {
+public:
+
+    InspectorServer(V8Context* context, int port);
+    ~InspectorServer();
+
+    InspectorServer(const InspectorServer&) = delete;
+    InspectorServer& operator=(const InspectorServer&) = delete;
+
+    // binds and starts the thread, false if port could not be bound
+    bool Start();
+    void Stop();
+
+    inline int Port() const {
+        return _port;
+    }
+
+    // JS thread, message is dropped if no client is connected
+    void Send(const v8_inspector::StringView &message);
+
+private:
+
+    static void* ThreadMain(void* data);
+
+    void Run();
+    void Accept();
+    bool HandleHttp(int fd);
+    bool ReadFrames();
+    // decodes complete frames buffered in _input, false if client must be closed
+    bool ParseFrames();
+    void CloseClient();
+
+    bool WriteAll(int fd, const char* data, size_t length);
+    void WriteFrame(int fd, uint8_t opcode, const char* payload, size_t length);
+    void WriteHttp(int fd, const char* status, const char* contentType, const std::string &body);
+
+    std::string TargetList();
+
+    V8Context* _context;
+    const int _port;
+    std::string _id;
+    pthread_t _thread = {};
+    bool _started = false;
+
+    int _listenFd = -1;
+    // written by Stop to wake the poll loop
+    int _wakeFds[2] = { -1, -1 };
+
+    // guards _clientFd and _frame, writes happen on JS thread
+    std::mutex _sendLock;
+    int _clientFd = -1;
+    std::string _frame;
+
+    // server thread
+    std::string _input;
+    std::string _message;
+    std::u16string _message16;
+};
+
+#endif //ANDROID_INSPECTORSERVER_H
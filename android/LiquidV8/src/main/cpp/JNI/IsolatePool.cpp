@@ -0,0 +1,102 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "IsolatePool.h"
+
+IsolatePool* IsolatePool::Shared() {
+    // lives as long as the process, same as the platform
+    static IsolatePool* pool = new IsolatePool();
+    return pool;
+}
+
+void IsolatePool::Prewarm(int count, ClrEnv env) {
+    V8Context::InitializeV8(env);
+    std::lock_guard<std::mutex> lock(_lock);
+    _env = *env;
+    _target = count < 0 ? 0 : static_cast<size_t>(count);
+    // detached thread is not joinable, so a flag keeps it to one producer
+    if (!_started) {
+        _started = true;
+        _thread = std::thread(&IsolatePool::Run, this);
+        _thread.detach();
+    }
+    _signal.notify_one();
+}
+
+void IsolatePool::SetPolicy(PoolPolicy policy) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _policy = policy;
+}
+
+V8Context* IsolatePool::Acquire(bool debug, ClrEnv env) {
+    V8Context* c = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_ready.empty()) {
+            return nullptr;
+        }
+        c = _ready.front();
+        _ready.pop_front();
+        _hits++;
+        // refill in background
+        _signal.notify_one();
+    }
+    c->EnterThread();
+    c->Adopt(debug, env);
+    return c;
+}
+
+bool IsolatePool::Recycle(V8Context* context) {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_policy != PoolPolicy::Recycle || _ready.size() + _dirty.size() >= _target) {
+            return false;
+        }
+    }
+    // release everything CLR holds on this thread, the
+    // context itself is reset in background
+    context->PrepareForPool();
+    context->ExitThread();
+    std::lock_guard<std::mutex> lock(_lock);
+    _dirty.push_back(context);
+    _recycled++;
+    _signal.notify_one();
+    return true;
+}
+
+void IsolatePool::GetStatistics(__PoolStatistics* statistics) {
+    std::lock_guard<std::mutex> lock(_lock);
+    statistics->ready = static_cast<int32_t>(_ready.size());
+    statistics->hits = _hits;
+    statistics->recycled = _recycled;
+}
+
+void IsolatePool::Run() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (true) {
+        _signal.wait(lock, [this] {
+            return !_dirty.empty() || _ready.size() < _target;
+        });
+
+        V8Context* c = nullptr;
+        __ClrEnv env = _env;
+        if (!_dirty.empty()) {
+            c = _dirty.front();
+            _dirty.pop_front();
+        }
+
+        // creating isolate takes time, do not block acquire
+        lock.unlock();
+        if (c == nullptr) {
+            c = new V8Context(false, &env);
+        } else {
+            c->EnterThread();
+            c->Reset();
+        }
+        c->ExitThread();
+        lock.lock();
+
+        _ready.push_back(c);
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_ISOLATEPOOL_H
+#define ANDROID_ISOLATEPOOL_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "V8Context.h"
+
+enum PoolPolicy: int {
+    // disposed contexts are destroyed
+    Discard = 0,
+    // disposed contexts get a fresh v8::Context and go back to the pool
+    Recycle = 1
+};
+
+extern "C" {
+
+    // filled by V8Context_GetPoolStatistics, counts are since process start
+    struct __PoolStatistics {
+        int32_t ready;
+        int32_t hits;
+        int32_t recycled;
+    };
+}
+
+/**
+ * Keeps isolates and contexts ready to be handed out.
+ *
+ * Contexts are created (and recycled ones are reset) on a background thread,
+ * they are not bound to any thread while they sit in the pool, the thread
+ * that acquires one enters it.
+ * **/
+class IsolatePool {
+public:
+
+    static IsolatePool* Shared();
+
+    /**
+     * Keeps `count` contexts ready, V8 is initialized on the calling thread
+     * before the background thread is started.
+     * **/
+    void Prewarm(int count, ClrEnv env);
+
+    void SetPolicy(PoolPolicy policy);
+
+    /**
+     * Returns a ready context entered on the calling thread,
+     * or nullptr if the pool is empty.
+     * **/
+    V8Context* Acquire(bool debug, ClrEnv env);
+
+    /**
+     * Called from V8Context_Dispose on the thread that owns the context,
+     * returns false if the context should be disposed by the caller.
+     * **/
+    bool Recycle(V8Context* context);
+
+    void GetStatistics(__PoolStatistics* statistics);
+
+private:
+
+    IsolatePool() = default;
+
+    void Run();
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::thread _thread;
+    bool _started = false;
+
+    std::deque<V8Context*> _ready;
+    std::deque<V8Context*> _dirty;
+
+    __ClrEnv _env = {};
+    size_t _target = 0;
+    // contexts handed out by Acquire and taken back by Recycle
+    int32_t _hits = 0;
+    int32_t _recycled = 0;
+    PoolPolicy _policy = PoolPolicy::Discard;
+};
+
+#endif //ANDROID_ISOLATEPOOL_H
@@ -0,0 +1,110 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "JSThread.h"
+
+JSThread::JSThread(size_t stackSize):
+    _stackSize(stackSize) {
+}
+
+bool JSThread::Start(
+        std::function<void()> onStart,
+        std::function<void()> onStop,
+        std::function<void()> onIdle) {
+    _onStart = onStart;
+    _onStop = onStop;
+    _onIdle = onIdle;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, _stackSize);
+    int r = pthread_create(&_thread, &attr, &JSThread::ThreadMain, this);
+    pthread_attr_destroy(&attr);
+    return r == 0;
+}
+
+void* JSThread::ThreadMain(void* data) {
+    JSThread* self = static_cast<JSThread*>(data);
+    self->Run();
+    return nullptr;
+}
+
+void JSThread::Post(std::function<void()> task, double delaySeconds) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_stopping) {
+        return;
+    }
+    if (delaySeconds <= 0) {
+        _tasks.push_back(std::move(task));
+    } else {
+        auto delay = std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(delaySeconds));
+        _delayed.push({ Clock::now() + delay, _sequence++, std::move(task) });
+    }
+    _signal.notify_one();
+}
+
+void JSThread::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _stopping = true;
+        _signal.notify_one();
+    }
+    pthread_join(_thread, nullptr);
+}
+
+void JSThread::Detach() {
+    std::lock_guard<std::mutex> lock(_lock);
+    _stopping = true;
+    _detached = true;
+    _tasks.clear();
+    pthread_detach(_thread);
+}
+
+bool JSThread::IsCurrentThread() const {
+    return pthread_equal(_thread, pthread_self()) != 0;
+}
+
+void JSThread::Run() {
+    _onStart();
+    std::unique_lock<std::mutex> lock(_lock);
+    bool idle = false;
+    while (!_detached) {
+        auto now = Clock::now();
+        while (!_stopping && !_delayed.empty() && _delayed.top().due <= now) {
+            _tasks.push_back(_delayed.top().task);
+            _delayed.pop();
+        }
+        if (!_tasks.empty()) {
+            std::function<void()> task = std::move(_tasks.front());
+            _tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            idle = false;
+            continue;
+        }
+        if (_stopping) {
+            break;
+        }
+        if (!idle && _onIdle) {
+            idle = true;
+            lock.unlock();
+            _onIdle();
+            lock.lock();
+            continue;
+        }
+        if (_delayed.empty()) {
+            _signal.wait(lock);
+        } else {
+            _signal.wait_until(lock, _delayed.top().due);
+        }
+    }
+    bool detached = _detached;
+    lock.unlock();
+    if (detached) {
+        delete this;
+        return;
+    }
+    _onStop();
+}
@@ -0,0 +1,90 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_JSTHREAD_H
+#define ANDROID_JSTHREAD_H
+
+#include <pthread.h>
+#include <chrono>
+#include <deque>
+#include <queue>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * Native thread with its own task queue, isolate is entered once
+ * by `onStart` and every task runs on this thread.
+ * **/
+class JSThread {
+public:
+
+    typedef std::chrono::steady_clock Clock;
+
+    explicit JSThread(size_t stackSize);
+
+    inline size_t StackSize() const {
+        return _stackSize;
+    }
+
+    /**
+     * `onStart` runs on the new thread before first task,
+     * `onStop` runs after the last task when thread is stopped,
+     * `onIdle` runs once every time the queue is drained.
+     * **/
+    bool Start(
+            std::function<void()> onStart,
+            std::function<void()> onStop,
+            std::function<void()> onIdle = nullptr);
+
+    void Post(std::function<void()> task, double delaySeconds = 0);
+
+    /**
+     * Runs pending tasks (delayed tasks are dropped), then `onStop`
+     * and waits for the thread to finish.
+     * **/
+    void Stop();
+
+    /**
+     * Used when thread is stopped from one of its own tasks, pending tasks are
+     * dropped, `onStop` is not called and the thread deletes itself.
+     * **/
+    void Detach();
+
+    bool IsCurrentThread() const;
+
+private:
+
+    struct DelayedTask {
+        Clock::time_point due;
+        uint64_t sequence;
+        std::function<void()> task;
+
+        bool operator > (const DelayedTask &other) const {
+            return due == other.due ? sequence > other.sequence : due > other.due;
+        }
+    };
+
+    static void* ThreadMain(void* data);
+
+    void Run();
+
+    const size_t _stackSize;
+    pthread_t _thread = {};
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::deque<std::function<void()>> _tasks;
+    std::priority_queue<DelayedTask, std::vector<DelayedTask>, std::greater<DelayedTask>> _delayed;
+    uint64_t _sequence = 0;
+    bool _stopping = false;
+    bool _detached = false;
+
+    std::function<void()> _onStart;
+    std::function<void()> _onStop;
+    std::function<void()> _onIdle;
+};
+
+#endif //ANDROID_JSTHREAD_H
@@ -0,0 +1,194 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_JSONWRITER_H
+#define ANDROID_JSONWRITER_H
+
+#include <unistd.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/**
+ * Streams JSON to a file descriptor through a fixed buffer, so profiles
+ * of any size are written without building the document in memory.
+ * Commas are inserted by the writer, caller only nests Begin/End and
+ * puts Key before each member value. Strings are UTF-8.
+ * **/
+class JsonWriter {
+public:
+    static const size_t kBufferSize = 64 * 1024;
+
+    explicit JsonWriter(int fd):
+        _fd(fd),
+        _buffer(new char[kBufferSize]) {
+    }
+
+    ~JsonWriter() {
+        Flush();
+    }
+
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    void BeginObject() {
+        Value();
+        Put('{');
+        _hasMember.push_back(false);
+    }
+
+    void EndObject() {
+        _hasMember.pop_back();
+        Put('}');
+    }
+
+    void BeginArray() {
+        Value();
+        Put('[');
+        _hasMember.push_back(false);
+    }
+
+    void EndArray() {
+        _hasMember.pop_back();
+        Put(']');
+    }
+
+    void Key(const char* name) {
+        Value();
+        WriteString(name, strlen(name));
+        Put(':');
+        _afterKey = true;
+    }
+
+    void String(const char* text) {
+        String(text, text == nullptr ? 0 : strlen(text));
+    }
+
+    void String(const char* text, size_t length) {
+        Value();
+        WriteString(text, length);
+    }
+
+    void Int(int64_t value) {
+        Value();
+        char text[24];
+        int n = snprintf(text, sizeof(text), "%lld", static_cast<long long>(value));
+        Put(text, static_cast<size_t>(n));
+    }
+
+    void Number(double value) {
+        Value();
+        if (!std::isfinite(value)) {
+            Put("null", 4);
+            return;
+        }
+        char text[32];
+        int n = snprintf(text, sizeof(text), "%.17g", value);
+        Put(text, static_cast<size_t>(n));
+    }
+
+    // writes buffered output, false once any write has failed
+    bool Flush() {
+        size_t offset = 0;
+        while (!_failed && offset < _used) {
+            ssize_t r = write(_fd, _buffer.get() + offset, _used - offset);
+            if (r < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                _failed = true;
+                break;
+            }
+            offset += static_cast<size_t>(r);
+        }
+        _used = 0;
+        return !_failed;
+    }
+
+    inline bool Failed() const {
+        return _failed;
+    }
+
+private:
+
+    // comma before every member but the first, none after a key
+    void Value() {
+        if (_afterKey) {
+            _afterKey = false;
+            return;
+        }
+        if (_hasMember.empty()) {
+            return;
+        }
+        if (_hasMember.back()) {
+            Put(',');
+        } else {
+            _hasMember.back() = true;
+        }
+    }
+
+    void WriteString(const char* text, size_t length) {
+        static const char* kHex = "0123456789abcdef";
+        Put('"');
+        size_t start = 0;
+        for (size_t i = 0; i < length; i++) {
+            uint8_t c = static_cast<uint8_t>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            Put(text + start, i - start);
+            start = i + 1;
+            switch (c) {
+                case '"': Put("\\\"", 2); break;
+                case '\\': Put("\\\\", 2); break;
+                case '\n': Put("\\n", 2); break;
+                case '\r': Put("\\r", 2); break;
+                case '\t': Put("\\t", 2); break;
+                default: {
+                    char escape[6] = { '\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF] };
+                    Put(escape, sizeof(escape));
+                }
+            }
+        }
+        Put(text + start, length - start);
+        Put('"');
+    }
+
+    inline void Put(char c) {
+        if (_used == kBufferSize) {
+            Flush();
+        }
+        _buffer[_used++] = c;
+    }
+
+    void Put(const char* data, size_t length) {
+        while (length > 0) {
+            if (_used == kBufferSize) {
+                Flush();
+            }
+            size_t n = kBufferSize - _used;
+            if (n > length) {
+                n = length;
+            }
+            memcpy(_buffer.get() + _used, data, n);
+            _used += n;
+            data += n;
+            length -= n;
+        }
+    }
+
+    int _fd;
+    std::unique_ptr<char[]> _buffer;
+    size_t _used = 0;
+    bool _failed = false;
+    bool _afterKey = false;
+    // one entry per open object or array
+    std::vector<bool> _hasMember;
+};
+
+#endif //ANDROID_JSONWRITER_H
@@ -0,0 +1,280 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "Profiler.h"
+#include "V8Context.h"
+
+#include <unistd.h>
+#include <cerrno>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::EmbedderGraph;
+using v8::AllocationProfile;
+
+typedef std::unordered_map<const AllocationProfile::Node*, size_t> AllocationTotals;
+
+static void WriteCallFrame(const CpuProfileNode* node, JsonWriter &w) {
+    w.BeginObject();
+    w.Key("functionName");
+    w.String(node->GetFunctionNameStr());
+    w.Key("scriptId");
+    w.String(std::to_string(node->GetScriptId()).c_str());
+    w.Key("url");
+    w.String(node->GetScriptResourceNameStr());
+    // protocol is zero based, V8 reports kNoLineNumberInfo (0) as -1
+    w.Key("lineNumber");
+    w.Int(node->GetLineNumber() - 1);
+    w.Key("columnNumber");
+    w.Int(node->GetColumnNumber() - 1);
+    w.EndObject();
+}
+
+static void WriteNode(
+        const CpuProfileNode* node,
+        JsonWriter &w,
+        std::vector<CpuProfileNode::LineTick> &ticks) {
+    w.BeginObject();
+    w.Key("id");
+    w.Int(node->GetNodeId());
+    w.Key("callFrame");
+    WriteCallFrame(node, w);
+    w.Key("hitCount");
+    w.Int(node->GetHitCount());
+
+    int count = node->GetChildrenCount();
+    if (count > 0) {
+        w.Key("children");
+        w.BeginArray();
+        for (int i = 0; i < count; i++) {
+            w.Int(node->GetChild(i)->GetNodeId());
+        }
+        w.EndArray();
+    }
+
+    unsigned int lines = node->GetHitLineCount();
+    if (lines > 0) {
+        ticks.resize(lines);
+        if (node->GetLineTicks(ticks.data(), lines)) {
+            w.Key("positionTicks");
+            w.BeginArray();
+            for (unsigned int i = 0; i < lines; i++) {
+                w.BeginObject();
+                w.Key("line");
+                w.Int(ticks[i].line);
+                w.Key("ticks");
+                w.Int(ticks[i].hit_count);
+                w.EndObject();
+            }
+            w.EndArray();
+        }
+    }
+
+    const char* reason = node->GetBailoutReason();
+    if (reason != nullptr && reason[0] != 0) {
+        w.Key("deoptReason");
+        w.String(reason);
+    }
+    w.EndObject();
+}
+
+void Profiler::WriteCpuProfile(const CpuProfile* profile, JsonWriter &w) {
+    w.BeginObject();
+
+    w.Key("nodes");
+    w.BeginArray();
+    // explicit stack, deep recursion in JS must not overflow native stack here
+    std::vector<const CpuProfileNode*> stack;
+    std::vector<CpuProfileNode::LineTick> ticks;
+    stack.push_back(profile->GetTopDownRoot());
+    while (!stack.empty()) {
+        const CpuProfileNode* node = stack.back();
+        stack.pop_back();
+        WriteNode(node, w, ticks);
+        for (int i = node->GetChildrenCount() - 1; i >= 0; i--) {
+            stack.push_back(node->GetChild(i));
+        }
+    }
+    w.EndArray();
+
+    w.Key("startTime");
+    w.Int(profile->GetStartTime());
+    w.Key("endTime");
+    w.Int(profile->GetEndTime());
+
+    int samples = profile->GetSamplesCount();
+    w.Key("samples");
+    w.BeginArray();
+    for (int i = 0; i < samples; i++) {
+        w.Int(profile->GetSample(i)->GetNodeId());
+    }
+    w.EndArray();
+
+    w.Key("timeDeltas");
+    w.BeginArray();
+    int64_t last = profile->GetStartTime();
+    for (int i = 0; i < samples; i++) {
+        int64_t time = profile->GetSampleTimestamp(i);
+        w.Int(time - last);
+        last = time;
+    }
+    w.EndArray();
+
+    w.EndObject();
+}
+
+static size_t SelfSize(const AllocationProfile::Node* node) {
+    size_t size = 0;
+    for (auto &a : node->allocations) {
+        size += a.size * a.count;
+    }
+    return size;
+}
+
+// depth is bounded by stack_depth given to sampler, recursion is fine
+static size_t TotalSize(const AllocationProfile::Node* node, AllocationTotals &totals) {
+    size_t size = SelfSize(node);
+    for (auto child : node->children) {
+        size += TotalSize(child, totals);
+    }
+    totals[node] = size;
+    return size;
+}
+
+static void WriteAllocationNode(
+        Isolate* isolate,
+        const AllocationProfile::Node* node,
+        AllocationTotals &totals,
+        JsonWriter &w) {
+    w.BeginObject();
+    w.Key("callFrame");
+    w.BeginObject();
+    w.Key("functionName");
+    v8::String::Utf8Value name(isolate, node->name);
+    w.String(*name, static_cast<size_t>(name.length()));
+    w.Key("scriptId");
+    w.String(std::to_string(node->script_id).c_str());
+    w.Key("url");
+    v8::String::Utf8Value url(isolate, node->script_name);
+    w.String(*url, static_cast<size_t>(url.length()));
+    w.Key("lineNumber");
+    w.Int(node->line_number - 1);
+    w.Key("columnNumber");
+    w.Int(node->column_number - 1);
+    w.EndObject();
+    w.Key("selfSize");
+    w.Int(static_cast<int64_t>(SelfSize(node)));
+    w.Key("id");
+    w.Int(node->node_id);
+    w.Key("children");
+    w.BeginArray();
+    for (auto child : node->children) {
+        if (totals[child] > 0) {
+            WriteAllocationNode(isolate, child, totals, w);
+        }
+    }
+    w.EndArray();
+    w.EndObject();
+}
+
+void Profiler::WriteAllocationProfile(Isolate* isolate, AllocationProfile* profile, JsonWriter &w) {
+    HandleScope scope(isolate);
+    AllocationTotals totals;
+    AllocationProfile::Node* root = profile->GetRootNode();
+    TotalSize(root, totals);
+    w.BeginObject();
+    w.Key("head");
+    WriteAllocationNode(isolate, root, totals, w);
+    w.EndObject();
+}
+
+class ClrHandleNode : public EmbedderGraph::Node {
+public:
+    ClrHandleNode(const char* name, size_t size, bool root):
+        _name(name),
+        _size(size),
+        _root(root) {
+    }
+
+    const char* Name() override {
+        return _name;
+    }
+
+    size_t SizeInBytes() override {
+        return _size;
+    }
+
+    bool IsRootNode() override {
+        return _root;
+    }
+
+private:
+    const char* _name;
+    size_t _size;
+    bool _root;
+};
+
+class ClrHandleVisitor : public v8::PersistentHandleVisitor {
+public:
+    ClrHandleVisitor(Isolate* isolate, EmbedderGraph* graph, EmbedderGraph::Node* root):
+        _isolate(isolate),
+        _graph(graph),
+        _root(root) {
+    }
+
+    void VisitPersistentHandle(v8::Persistent<Value>* value, uint16_t classId) override {
+        if (classId != WRAPPED_CLASS) {
+            return;
+        }
+        Local<Value> v = Local<Value>::New(_isolate, *value);
+        if (v.IsEmpty()) {
+            return;
+        }
+        // externals wrap CLR objects, rest are JS values referenced by CLR
+        bool external = v->IsExternal();
+        EmbedderGraph::Node* node = _graph->AddNode(std::unique_ptr<EmbedderGraph::Node>(
+                new ClrHandleNode(
+                        external ? "CLR object" : "CLR handle",
+                        external ? sizeof(V8External) : sizeof(Global<Value>),
+                        false)));
+        _graph->AddEdge(_root, node);
+        // small integers and oddballs have no node of their own
+        if (external || v->IsObject() || v->IsString() || v->IsSymbol()) {
+            _graph->AddEdge(node, _graph->V8Node(v));
+        }
+    }
+
+private:
+    Isolate* _isolate;
+    EmbedderGraph* _graph;
+    EmbedderGraph::Node* _root;
+};
+
+void Profiler::BuildClrHandleGraph(Isolate* isolate, EmbedderGraph* graph, void* data) {
+    HandleScope scope(isolate);
+    EmbedderGraph::Node* root = graph->AddNode(std::unique_ptr<EmbedderGraph::Node>(
+            new ClrHandleNode("CLR handles", 0, true)));
+    ClrHandleVisitor visitor(isolate, graph, root);
+    isolate->VisitHandlesWithClassIds(&visitor);
+}
+
+v8::OutputStream::WriteResult Profiler::FileOutputStream::WriteAsciiChunk(char* data, int size) {
+    size_t offset = 0;
+    size_t length = static_cast<size_t>(size);
+    while (offset < length) {
+        ssize_t r = write(_fd, data + offset, length - offset);
+        if (r < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _failed = true;
+            return kAbort;
+        }
+        offset += static_cast<size_t>(r);
+    }
+    return kContinue;
+}
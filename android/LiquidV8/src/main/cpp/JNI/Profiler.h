@@ -0,0 +1,61 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_PROFILER_H
+#define ANDROID_PROFILER_H
+
+#include "v8-profiler.h"
+#include "JsonWriter.h"
+
+/**
+ * Serializers for profiles collected by V8Context, output matches what
+ * DevTools loads from disk.
+ * **/
+namespace Profiler {
+
+    // Chrome's .cpuprofile, nodes in pre order followed by samples
+    void WriteCpuProfile(const v8::CpuProfile* profile, JsonWriter &writer);
+
+    /**
+     * DevTools .heapprofile tree of sampled allocations still alive, nodes
+     * without allocations in their subtree and per sample list are left out.
+     * **/
+    void WriteAllocationProfile(v8::Isolate* isolate, v8::AllocationProfile* profile, JsonWriter &writer);
+
+    /**
+     * Adds a named native node for every handle held by CLR (WRAPPED_CLASS)
+     * with an edge to the value it keeps alive, so retention through CLR
+     * wrappers is visible. Used with AddBuildEmbedderGraphCallback.
+     * **/
+    void BuildClrHandleGraph(v8::Isolate* isolate, v8::EmbedderGraph* graph, void* data);
+
+    // heap snapshot chunks go straight to a file descriptor
+    class FileOutputStream : public v8::OutputStream {
+    public:
+        explicit FileOutputStream(int fd): _fd(fd) {
+        }
+
+        int GetChunkSize() override {
+            return kChunkSize;
+        }
+
+        WriteResult WriteAsciiChunk(char* data, int size) override;
+
+        void EndOfStream() override {
+        }
+
+        inline bool Failed() const {
+            return _failed;
+        }
+
+    private:
+        static const int kChunkSize = 64 * 1024;
+
+        int _fd;
+        bool _failed = false;
+    };
+
+}
+
+#endif //ANDROID_PROFILER_H
@@ -0,0 +1,160 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "ThreadPlatform.h"
+#include "JSThread.h"
+
+#include <mutex>
+#include <unordered_map>
+
+// guards threads, a thread is never posted to after Unregister returns
+static std::mutex lock;
+static std::unordered_map<v8::Isolate*, JSThread*> threads;
+
+// empty task, thread pumps platform tasks once its queue drains
+static void Wake(v8::Isolate* isolate, double delayInSeconds) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = threads.find(isolate);
+    if (it != threads.end()) {
+        it->second->Post([] {}, delayInSeconds);
+    }
+}
+
+class WakingTaskRunner : public v8::TaskRunner {
+public:
+    WakingTaskRunner(std::shared_ptr<v8::TaskRunner> inner, v8::Isolate* isolate):
+        _inner(std::move(inner)),
+        _isolate(isolate) {
+    }
+
+    void PostTask(std::unique_ptr<v8::Task> task) override {
+        _inner->PostTask(std::move(task));
+        Wake(_isolate, 0);
+    }
+
+    void PostNonNestableTask(std::unique_ptr<v8::Task> task) override {
+        _inner->PostNonNestableTask(std::move(task));
+        Wake(_isolate, 0);
+    }
+
+    void PostDelayedTask(std::unique_ptr<v8::Task> task, double delayInSeconds) override {
+        _inner->PostDelayedTask(std::move(task), delayInSeconds);
+        Wake(_isolate, delayInSeconds);
+    }
+
+    void PostNonNestableDelayedTask(std::unique_ptr<v8::Task> task, double delayInSeconds) override {
+        _inner->PostNonNestableDelayedTask(std::move(task), delayInSeconds);
+        Wake(_isolate, delayInSeconds);
+    }
+
+    // idle tasks repost themselves while they have work, waking for them
+    // would keep the thread busy, they run on the next drain
+    void PostIdleTask(std::unique_ptr<v8::IdleTask> task) override {
+        _inner->PostIdleTask(std::move(task));
+    }
+
+    bool IdleTasksEnabled() override {
+        return _inner->IdleTasksEnabled();
+    }
+
+    bool NonNestableTasksEnabled() const override {
+        return _inner->NonNestableTasksEnabled();
+    }
+
+    bool NonNestableDelayedTasksEnabled() const override {
+        return _inner->NonNestableDelayedTasksEnabled();
+    }
+
+private:
+    std::shared_ptr<v8::TaskRunner> _inner;
+    v8::Isolate* _isolate;
+};
+
+ThreadPlatform::ThreadPlatform(std::unique_ptr<v8::Platform> inner):
+    _inner(std::move(inner)) {
+}
+
+void ThreadPlatform::Register(v8::Isolate* isolate, JSThread* thread) {
+    std::lock_guard<std::mutex> guard(lock);
+    threads[isolate] = thread;
+}
+
+void ThreadPlatform::Unregister(v8::Isolate* isolate) {
+    std::lock_guard<std::mutex> guard(lock);
+    threads.erase(isolate);
+}
+
+v8::PageAllocator* ThreadPlatform::GetPageAllocator() {
+    return _inner->GetPageAllocator();
+}
+
+void ThreadPlatform::OnCriticalMemoryPressure() {
+    _inner->OnCriticalMemoryPressure();
+}
+
+bool ThreadPlatform::OnCriticalMemoryPressure(size_t length) {
+    return _inner->OnCriticalMemoryPressure(length);
+}
+
+int ThreadPlatform::NumberOfWorkerThreads() {
+    return _inner->NumberOfWorkerThreads();
+}
+
+std::shared_ptr<v8::TaskRunner> ThreadPlatform::GetForegroundTaskRunner(v8::Isolate* isolate) {
+    return std::make_shared<WakingTaskRunner>(_inner->GetForegroundTaskRunner(isolate), isolate);
+}
+
+void ThreadPlatform::CallOnWorkerThread(std::unique_ptr<v8::Task> task) {
+    _inner->CallOnWorkerThread(std::move(task));
+}
+
+void ThreadPlatform::CallBlockingTaskOnWorkerThread(std::unique_ptr<v8::Task> task) {
+    _inner->CallBlockingTaskOnWorkerThread(std::move(task));
+}
+
+void ThreadPlatform::CallLowPriorityTaskOnWorkerThread(std::unique_ptr<v8::Task> task) {
+    _inner->CallLowPriorityTaskOnWorkerThread(std::move(task));
+}
+
+void ThreadPlatform::CallDelayedOnWorkerThread(std::unique_ptr<v8::Task> task, double delayInSeconds) {
+    _inner->CallDelayedOnWorkerThread(std::move(task), delayInSeconds);
+}
+
+// deprecated entry points, routed through the task runner so they wake too
+
+void ThreadPlatform::CallOnForegroundThread(v8::Isolate* isolate, v8::Task* task) {
+    GetForegroundTaskRunner(isolate)->PostTask(std::unique_ptr<v8::Task>(task));
+}
+
+void ThreadPlatform::CallDelayedOnForegroundThread(v8::Isolate* isolate, v8::Task* task, double delayInSeconds) {
+    GetForegroundTaskRunner(isolate)->PostDelayedTask(std::unique_ptr<v8::Task>(task), delayInSeconds);
+}
+
+void ThreadPlatform::CallIdleOnForegroundThread(v8::Isolate* isolate, v8::IdleTask* task) {
+    GetForegroundTaskRunner(isolate)->PostIdleTask(std::unique_ptr<v8::IdleTask>(task));
+}
+
+bool ThreadPlatform::IdleTasksEnabled(v8::Isolate* isolate) {
+    return _inner->IdleTasksEnabled(isolate);
+}
+
+double ThreadPlatform::MonotonicallyIncreasingTime() {
+    return _inner->MonotonicallyIncreasingTime();
+}
+
+double ThreadPlatform::CurrentClockTimeMillis() {
+    return _inner->CurrentClockTimeMillis();
+}
+
+v8::Platform::StackTracePrinter ThreadPlatform::GetStackTracePrinter() {
+    return _inner->GetStackTracePrinter();
+}
+
+v8::TracingController* ThreadPlatform::GetTracingController() {
+    return _inner->GetTracingController();
+}
+
+void ThreadPlatform::DumpWithoutCrashing() {
+    _inner->DumpWithoutCrashing();
+}
@@ -0,0 +1,78 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_THREADPLATFORM_H
+#define ANDROID_THREADPLATFORM_H
+
+#include "v8-platform.h"
+
+#include <memory>
+
+class JSThread;
+
+/**
+ * Forwards everything to DefaultPlatform, foreground tasks posted for an
+ * isolate that runs on its own JSThread also wake that thread, so it pumps
+ * them as soon as they are due instead of waiting for the next CLR task.
+ * Pumping still goes through DefaultPlatform, see `Inner`.
+ * **/
+class ThreadPlatform : public v8::Platform {
+public:
+
+    explicit ThreadPlatform(std::unique_ptr<v8::Platform> inner);
+
+    // platform created by NewDefaultPlatform, for PumpMessageLoop and RunIdleTasks
+    inline v8::Platform* Inner() {
+        return _inner.get();
+    }
+
+    /**
+     * Isolate's tasks wake thread until Unregister, thread must be
+     * unregistered before it is stopped or detached.
+     * **/
+    static void Register(v8::Isolate* isolate, JSThread* thread);
+
+    static void Unregister(v8::Isolate* isolate);
+
+    v8::PageAllocator* GetPageAllocator() override;
+
+    void OnCriticalMemoryPressure() override;
+
+    bool OnCriticalMemoryPressure(size_t length) override;
+
+    int NumberOfWorkerThreads() override;
+
+    std::shared_ptr<v8::TaskRunner> GetForegroundTaskRunner(v8::Isolate* isolate) override;
+
+    void CallOnWorkerThread(std::unique_ptr<v8::Task> task) override;
+
+    void CallBlockingTaskOnWorkerThread(std::unique_ptr<v8::Task> task) override;
+
+    void CallLowPriorityTaskOnWorkerThread(std::unique_ptr<v8::Task> task) override;
+
+    void CallDelayedOnWorkerThread(std::unique_ptr<v8::Task> task, double delayInSeconds) override;
+
+    void CallOnForegroundThread(v8::Isolate* isolate, v8::Task* task) override;
+
+    void CallDelayedOnForegroundThread(v8::Isolate* isolate, v8::Task* task, double delayInSeconds) override;
+
+    void CallIdleOnForegroundThread(v8::Isolate* isolate, v8::IdleTask* task) override;
+
+    bool IdleTasksEnabled(v8::Isolate* isolate) override;
+
+    double MonotonicallyIncreasingTime() override;
+
+    double CurrentClockTimeMillis() override;
+
+    StackTracePrinter GetStackTracePrinter() override;
+
+    v8::TracingController* GetTracingController() override;
+
+    void DumpWithoutCrashing() override;
+
+private:
+    std::unique_ptr<v8::Platform> _inner;
+};
+
+#endif //ANDROID_THREADPLATFORM_H
@@ -0,0 +1,233 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_TIMERWHEEL_H
+#define ANDROID_TIMERWHEEL_H
+
+#include <cstdint>
+
+/**
+ * Intrusive node, a timer is always linked in exactly one list (wheel slot
+ * or expired batch) or in none, so cancel is a plain unlink.
+ * **/
+struct TimerNode {
+    TimerNode* prev = nullptr;
+    TimerNode* next = nullptr;
+    uint64_t due = 0;
+    // wheel level, -1 when not in the wheel
+    int level = -1;
+
+    inline bool IsLinked() const {
+        return next != nullptr;
+    }
+
+    inline void Unlink() {
+        if (next != nullptr) {
+            prev->next = next;
+            next->prev = prev;
+            prev = nullptr;
+            next = nullptr;
+        }
+    }
+};
+
+/**
+ * Circular list with sentinel head.
+ * **/
+class TimerList {
+private:
+    TimerNode _head;
+
+public:
+    TimerList() {
+        _head.prev = &_head;
+        _head.next = &_head;
+    }
+
+    TimerList(const TimerList&) = delete;
+    TimerList& operator=(const TimerList&) = delete;
+
+    inline bool IsEmpty() const {
+        return _head.next == &_head;
+    }
+
+    inline void PushBack(TimerNode* node) {
+        node->prev = _head.prev;
+        node->next = &_head;
+        _head.prev->next = node;
+        _head.prev = node;
+    }
+
+    inline TimerNode* PopFront() {
+        if (IsEmpty()) {
+            return nullptr;
+        }
+        TimerNode* node = _head.next;
+        node->Unlink();
+        return node;
+    }
+};
+
+/**
+ * Hierarchical timer wheel with 1 tick resolution, four levels of 64 slots
+ * cover 2^24 ticks, longer timers wait in the last level and are cascaded
+ * again. Schedule and Cancel are O(1), Advance moves due timers into one
+ * batch so caller can run them together.
+ * **/
+class TimerWheel {
+public:
+    static const int kLevels = 4;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;
+    static const uint64_t kSlotMask = kSlots - 1;
+
+    explicit TimerWheel(uint64_t now): _now(now) {}
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    inline uint64_t Now() const {
+        return _now;
+    }
+
+    inline bool IsEmpty() const {
+        return _count == 0;
+    }
+
+    // timers due now or in the past fire on next tick
+    void Schedule(TimerNode* node, uint64_t due) {
+        Cancel(node);
+        node->due = due > _now ? due : _now + 1;
+        Insert(node);
+        _count++;
+    }
+
+    // also removes node from expired batch that has not run yet
+    void Cancel(TimerNode* node) {
+        if (node->level >= 0) {
+            _levelCount[node->level]--;
+            _count--;
+            node->level = -1;
+        }
+        node->Unlink();
+    }
+
+    /**
+     * Moves all timers due at or before `to` into expired, in due order.
+     * **/
+    void Advance(uint64_t to, TimerList &expired) {
+        while (_now < to) {
+            if (_count == 0) {
+                _now = to;
+                return;
+            }
+            if (LevelIsEmpty(0)) {
+                // nothing can expire before next cascade
+                uint64_t boundary = (_now | kSlotMask);
+                if (boundary >= to) {
+                    _now = to;
+                    return;
+                }
+                _now = boundary;
+            }
+            _now++;
+            if ((_now & kSlotMask) == 0) {
+                Cascade();
+            }
+            TimerList &slot = _slots[0][_now & kSlotMask];
+            while (TimerNode* node = slot.PopFront()) {
+                _levelCount[0]--;
+                _count--;
+                node->level = -1;
+                expired.PushBack(node);
+            }
+        }
+    }
+
+    /**
+     * Earliest tick at which Advance has work to do, either a timer
+     * expires or a higher level slot must be cascaded. UINT64_MAX if empty.
+     * **/
+    uint64_t NextExpiry() const {
+        if (_count == 0) {
+            return UINT64_MAX;
+        }
+        uint64_t next = UINT64_MAX;
+        if (!LevelIsEmpty(0)) {
+            for (uint64_t i = 1; i <= kSlots; i++) {
+                if (!_slots[0][(_now + i) & kSlotMask].IsEmpty()) {
+                    next = _now + i;
+                    break;
+                }
+            }
+        }
+        for (int level = 1; level < kLevels; level++) {
+            if (LevelIsEmpty(level)) {
+                continue;
+            }
+            int shift = level * kSlotBits;
+            uint64_t span = static_cast<uint64_t>(1) << (shift + kSlotBits);
+            uint64_t base = (_now >> (shift + kSlotBits)) << (shift + kSlotBits);
+            for (uint64_t s = 0; s < kSlots; s++) {
+                if (_slots[level][s].IsEmpty()) {
+                    continue;
+                }
+                uint64_t start = base + (s << shift);
+                if (start <= _now) {
+                    start += span;
+                }
+                if (start < next) {
+                    next = start;
+                }
+            }
+        }
+        return next;
+    }
+
+private:
+    uint64_t _now;
+    uint64_t _count = 0;
+    uint64_t _levelCount[kLevels] = {};
+    TimerList _slots[kLevels][kSlots];
+
+    inline bool LevelIsEmpty(int level) const {
+        return _levelCount[level] == 0;
+    }
+
+    void Insert(TimerNode* node) {
+        uint64_t delta = node->due - _now;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (static_cast<uint64_t>(1) << ((level + 1) * kSlotBits))) {
+            level++;
+        }
+        uint64_t due = node->due;
+        uint64_t max = static_cast<uint64_t>(1) << (kLevels * kSlotBits);
+        if (delta >= max) {
+            // parked in last level, cascaded again when its slot comes up
+            due = _now + max - 1;
+        }
+        uint64_t slot = (due >> (level * kSlotBits)) & kSlotMask;
+        _slots[level][slot].PushBack(node);
+        _levelCount[level]++;
+        node->level = level;
+    }
+
+    // moves timers of higher level slots that start now into lower levels
+    void Cascade() {
+        for (int level = 1; level < kLevels; level++) {
+            int shift = level * kSlotBits;
+            uint64_t index = (_now >> shift) & kSlotMask;
+            TimerList &slot = _slots[level][index];
+            while (TimerNode* node = slot.PopFront()) {
+                _levelCount[level]--;
+                Insert(node);
+            }
+            if (index != 0) {
+                break;
+            }
+        }
+    }
+};
+
+#endif //ANDROID_TIMERWHEEL_H
@@ -0,0 +1,128 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "Tracing.h"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+using v8::platform::tracing::TraceBuffer;
+using v8::platform::tracing::TraceConfig;
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+using v8::platform::tracing::TracingController;
+
+// TRACE_EVENT_PHASE_COMPLETE, duration is filled in by End
+static const char kPhaseComplete = 'X';
+
+static const uint8_t kDisabled = 0;
+
+const uint8_t* Tracing::exportCategory = &kDisabled;
+
+static TracingController* controller = nullptr;
+
+static std::mutex lock;
+
+/**
+ * V8's JSON writer over a file that can be finished while the trace
+ * buffer owning the writer is still alive. Buffer is only replaced by
+ * next Start, a call traced across Stop may still update its event.
+ * **/
+class FileTraceWriter : public TraceWriter {
+public:
+    explicit FileTraceWriter(std::unique_ptr<std::ofstream> stream):
+        _stream(std::move(stream)),
+        _json(TraceWriter::CreateJSONTraceWriter(*_stream)) {
+    }
+
+    void AppendTraceEvent(TraceObject* event) override {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_json != nullptr) {
+            _json->AppendTraceEvent(event);
+        }
+    }
+
+    void Flush() override {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_json != nullptr) {
+            _json->Flush();
+        }
+    }
+
+    // JSON writer closes the event array when deleted
+    bool Close() {
+        std::lock_guard<std::mutex> guard(_lock);
+        _json.reset();
+        _stream->close();
+        return !_stream->fail();
+    }
+
+private:
+    std::mutex _lock;
+    std::unique_ptr<std::ofstream> _stream;
+    std::unique_ptr<TraceWriter> _json;
+};
+
+// owned by trace buffer of the controller
+static FileTraceWriter* writer = nullptr;
+
+std::unique_ptr<v8::TracingController> Tracing::CreateController() {
+    controller = new TracingController();
+    exportCategory = controller->GetCategoryGroupEnabled("xv8");
+    return std::unique_ptr<v8::TracingController>(controller);
+}
+
+bool Tracing::Start(const char* categories, const char* path) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (controller == nullptr || writer != nullptr) {
+        return false;
+    }
+    std::unique_ptr<std::ofstream> stream(new std::ofstream(path, std::ios::out | std::ios::trunc));
+    if (!stream->is_open()) {
+        return false;
+    }
+    writer = new FileTraceWriter(std::move(stream));
+    // ring buffer keeps latest events, it writes them all on Stop
+    controller->Initialize(TraceBuffer::CreateTraceBufferRingBuffer(
+            TraceBuffer::kRingBufferChunks,
+            writer));
+
+    TraceConfig* config = new TraceConfig();
+    config->SetTraceRecordMode(v8::platform::tracing::RECORD_CONTINUOUSLY);
+    std::stringstream list(categories == nullptr || categories[0] == 0 ? kDefaultCategories : categories);
+    std::string category;
+    while (std::getline(list, category, ',')) {
+        if (!category.empty()) {
+            config->AddIncludedCategory(category.c_str());
+        }
+    }
+    controller->StartTracing(config);
+    return true;
+}
+
+bool Tracing::Stop() {
+    std::lock_guard<std::mutex> guard(lock);
+    if (writer == nullptr) {
+        return false;
+    }
+    // flushes buffered events into writer
+    controller->StopTracing();
+    bool written = writer->Close();
+    writer = nullptr;
+    return written;
+}
+
+uint64_t Tracing::Begin(const char* name) {
+    return controller->AddTraceEvent(
+            kPhaseComplete, exportCategory, name,
+            nullptr, 0, 0,
+            0, nullptr, nullptr, nullptr, nullptr,
+            0);
+}
+
+void Tracing::End(const char* name, uint64_t handle) {
+    controller->UpdateTraceEventDuration(exportCategory, name, handle);
+}
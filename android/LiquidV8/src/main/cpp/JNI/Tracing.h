@@ -0,0 +1,72 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_TRACING_H
+#define ANDROID_TRACING_H
+
+#include "v8-platform.h"
+#include "libplatform/v8-tracing.h"
+
+#include <cstdint>
+#include <memory>
+
+/**
+ * Chrome trace events through the platform's TracingController. V8 emits
+ * its own GC, compile and execute events, exports and CLR callbacks add
+ * complete events under category "xv8", so all of them end up in one
+ * timeline. Tracing is process wide, same as the platform.
+ * **/
+namespace Tracing {
+
+    // categories recorded when caller passes none
+    static const char* const kDefaultCategories = "v8,v8.execute,xv8";
+
+    // zero unless "xv8" is being recorded, never null
+    extern const uint8_t* exportCategory;
+
+    // controller handed to NewDefaultPlatform, which owns it
+    std::unique_ptr<v8::TracingController> CreateController();
+
+    /**
+     * Starts recording comma separated categories into a JSON trace file
+     * at path, false if tracing is already running or file can't be opened.
+     * **/
+    bool Start(const char* categories, const char* path);
+
+    // stops recording and finishes the file, false if not running or write failed
+    bool Stop();
+
+    uint64_t Begin(const char* name);
+
+    void End(const char* name, uint64_t handle);
+
+    class Scope {
+    public:
+        // name must outlive trace, it is not copied
+        explicit Scope(const char* name) {
+            if (*exportCategory) {
+                _name = name;
+                _handle = Begin(name);
+            }
+        }
+
+        ~Scope() {
+            if (_name != nullptr) {
+                End(_name, _handle);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* _name = nullptr;
+        uint64_t _handle = 0;
+    };
+}
+
+// one byte load per export while tracing is off
+#define TRACE_EXPORT_SCOPE Tracing::Scope traceExportScope(__func__);
+
+#endif //ANDROID_TRACING_H
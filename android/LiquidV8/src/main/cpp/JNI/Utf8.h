@@ -0,0 +1,141 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_UTF8_H
+#define ANDROID_UTF8_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Transcoding between V8's one byte (Latin-1) and two byte (UTF-16)
+ * strings and UTF-8 text used on the wire. Invalid input, lone surrogates
+ * or malformed sequences, becomes U+FFFD.
+ * **/
+namespace Utf8 {
+
+    static const uint32_t kReplacement = 0xFFFD;
+
+    // bytes needed to encode Latin-1 text
+    inline size_t Length(const uint8_t* text, size_t length) {
+        size_t n = length;
+        for (size_t i = 0; i < length; i++) {
+            n += text[i] >> 7;
+        }
+        return n;
+    }
+
+    // upper bound, exact unless text has lone surrogates
+    inline size_t Length(const uint16_t* text, size_t length) {
+        size_t n = 0;
+        for (size_t i = 0; i < length; i++) {
+            uint16_t c = text[i];
+            n += c < 0x80 ? 1 : (c < 0x800 ? 2 : 3);
+        }
+        return n;
+    }
+
+    // writes Length(text, length) bytes, returns end of output
+    inline char* Write(const uint8_t* text, size_t length, char* out) {
+        for (size_t i = 0; i < length; i++) {
+            uint8_t c = text[i];
+            if (c < 0x80) {
+                *out++ = static_cast<char>(c);
+            } else {
+                *out++ = static_cast<char>(0xC0 | (c >> 6));
+                *out++ = static_cast<char>(0x80 | (c & 0x3F));
+            }
+        }
+        return out;
+    }
+
+    // writes at most Length(text, length) bytes, returns end of output
+    inline char* Write(const uint16_t* text, size_t length, char* out) {
+        for (size_t i = 0; i < length; i++) {
+            uint32_t c = text[i];
+            if (c < 0x80) {
+                *out++ = static_cast<char>(c);
+                continue;
+            }
+            if (c < 0x800) {
+                *out++ = static_cast<char>(0xC0 | (c >> 6));
+                *out++ = static_cast<char>(0x80 | (c & 0x3F));
+                continue;
+            }
+            if (c >= 0xD800 && c <= 0xDFFF) {
+                if (c <= 0xDBFF && i + 1 < length && text[i + 1] >= 0xDC00 && text[i + 1] <= 0xDFFF) {
+                    // pair takes 4 bytes, Length counted 6 for its two code units
+                    c = 0x10000 + ((c - 0xD800) << 10) + (text[++i] - 0xDC00);
+                    *out++ = static_cast<char>(0xF0 | (c >> 18));
+                    *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                    *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                    *out++ = static_cast<char>(0x80 | (c & 0x3F));
+                    continue;
+                }
+                c = kReplacement;
+            }
+            *out++ = static_cast<char>(0xE0 | (c >> 12));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+        return out;
+    }
+
+    template <typename T>
+    inline void Append(std::string &out, const T* text, size_t length) {
+        size_t start = out.size();
+        out.resize(start + Length(text, length));
+        char* begin = &out[0];
+        char* end = Write(text, length, begin + start);
+        out.resize(static_cast<size_t>(end - begin));
+    }
+
+    inline void ToUtf16(const char* text, size_t length, std::u16string &out) {
+        out.clear();
+        out.reserve(length);
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(text);
+        size_t i = 0;
+        while (i < length) {
+            uint32_t c = s[i];
+            if (c < 0x80) {
+                out.push_back(static_cast<char16_t>(c));
+                i++;
+                continue;
+            }
+            int extra = c >= 0xF0 ? 3 : (c >= 0xE0 ? 2 : (c >= 0xC0 ? 1 : -1));
+            if (extra < 0 || c > 0xF4 || i + extra >= length) {
+                out.push_back(static_cast<char16_t>(kReplacement));
+                i++;
+                continue;
+            }
+            uint32_t cp = c & (0x3F >> extra);
+            bool valid = true;
+            for (int k = 1; k <= extra; k++) {
+                uint8_t b = s[i + k];
+                if ((b & 0xC0) != 0x80) {
+                    valid = false;
+                    break;
+                }
+                cp = (cp << 6) | (b & 0x3F);
+            }
+            static const uint32_t kMin[] = { 0, 0x80, 0x800, 0x10000 };
+            if (!valid || cp < kMin[extra] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                out.push_back(static_cast<char16_t>(kReplacement));
+                i++;
+                continue;
+            }
+            i += extra + 1;
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                out.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+                out.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+            } else {
+                out.push_back(static_cast<char16_t>(cp));
+            }
+        }
+    }
+}
+
+#endif //ANDROID_UTF8_H
@@ -6,23 +6,35 @@
 #include "V8Context.h"
 #include "V8Response.h"
 #include "InspectorChannel.h"
+#include "InspectorServer.h"
 #include "ExternalX16String.h"
+#include "ExternalX8String.h"
+#include "ExternalMappedString.h"
+#include "JSThread.h"
+#include "ThreadPlatform.h"
+#include "Worker.h"
 #include "log.h"
+#include "Profiler.h"
+#include "Tracing.h"
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
 
 #define RETURN_EXCEPTION(e) \
     return FromException(context, e, __FILE__, __LINE__);                    \
 
 static bool _V8Initialized = false;
+static std::mutex _V8InitializeLock;
 
 static ExternalCall clrExternalCall;
 static FreeMemory  clrFreeMemory;
-// static AllocateMemory clrAllocateMemory;
+static AllocateMemory clrAllocateMemory;
 static AllocateString clrAllocateString;
 
 static FreeMemory clrFreeHandle;
 
 // static TV8Platform* _platform;
-static std::unique_ptr<v8::Platform> sPlatform;
+static std::unique_ptr<ThreadPlatform> sPlatform;
 static FatalErrorCallback fatalErrorCallback;
 void LogAndroid(const char* location, const char* message) {
     _log("%s %s", location, message);
@@ -39,33 +51,53 @@ void FatalErrorLogger(Local<Message> message, Local<Value> data) {
 
 static __ClrEnv clrEnv;
 
-V8Context::V8Context(
-        bool debug,
-        ClrEnv env)
-        {
+void V8Context::InitializeV8(ClrEnv env) {
+    // pool may create contexts on background thread
+    std::lock_guard<std::mutex> lock(_V8InitializeLock);
     if (!_V8Initialized) // (the API changed: https://groups.google.com/forum/#!topic/v8-users/wjMwflJkfso)
     {
         fatalErrorCallback = env->fatalErrorCallback;
         // clrAllocateMemory = env->allocateMemory;
         V8::InitializeICU();
 
-        sPlatform = v8::platform::NewDefaultPlatform();
+        // idle tasks are run by V8Context_RunIdleTasks and by context threads,
+        // wrapper wakes context threads when V8 posts foreground tasks
+        sPlatform.reset(new ThreadPlatform(v8::platform::NewDefaultPlatform(
+                0,
+                platform::IdleTaskSupport::kEnabled,
+                platform::InProcessStackDumping::kDisabled,
+                Tracing::CreateController())));
 
         V8::InitializePlatform(sPlatform.get());
 
         V8::Initialize();
         clrExternalCall = env->externalCall;
         clrFreeMemory = env->freeMemory;
+        clrAllocateMemory = env->allocateMemory;
         clrFreeHandle = env->freeHandle;
         clrAllocateString = env->allocateString;
         _V8Initialized = true;
     }
+}
+
+bool V8Context::IsV8Initialized() {
+    std::lock_guard<std::mutex> lock(_V8InitializeLock);
+    return _V8Initialized;
+}
+
+V8Context::V8Context(
+        bool debug,
+        ClrEnv env)
+        {
+    InitializeV8(env);
     // ReturnValue = (uint16_t*) malloc(2048);
+    _clrEnv = *env;
     _logger = env->loggerCallback;
-    _platform = sPlatform.get();
+    _queueTask = env->queueTask;
+    _platform = sPlatform->Inner();
     Isolate::CreateParams params;
-    _arrayBufferAllocator = ArrayBuffer::Allocator::NewDefaultAllocator();
-    params.array_buffer_allocator = _arrayBufferAllocator;
+    _arrayBufferAllocator.reset(ArrayBuffer::Allocator::NewDefaultAllocator());
+    params.array_buffer_allocator_shared = _arrayBufferAllocator;
 
     _isolate = Isolate::New(params);
 
@@ -100,21 +132,7 @@ V8Context::V8Context(
 
     _isolate->SetCaptureStackTraceForUncaughtExceptions(true, 10, v8::StackTrace::kOverview);
 
-    Local<v8::ObjectTemplate> global = ObjectTemplate::New(_isolate);
-    Local<v8::Context> c = Context::New(_isolate, nullptr, global);
-    // v8::Context::Scope context_scope(c);
-    _context.Reset(_isolate, c);
-
-    c->Enter();
-
-
-    Local<v8::Object> g = c->Global();
-
-    Local<v8::String> gn = V8_STRING("global");
-
-    g->Set(c, gn, g).ToChecked();
-
-    _global.Reset(_isolate, c->Global());
+    CreateContext();
 
     Local<v8::Symbol> s = v8::Symbol::New(_isolate, V8_STRING("WrappedInstance"));
     _wrapSymbol.Reset(_isolate, s);
@@ -134,11 +152,7 @@ V8Context::V8Context(
     _emptyString.Reset(_isolate, v8::String::Empty(_isolate));
 
     if (debug) {
-        inspectorClient = new XV8InspectorClient(
-                this,
-                true,
-                sPlatform.get(),
-                env);
+        AttachInspector();
     }
 
     handles.reserve(100);
@@ -151,7 +165,730 @@ V8Context::V8Context(
     }
 }
 
+void V8Context::CreateContext() {
+    HandleScope scope(_isolate);
+    Local<v8::ObjectTemplate> global = ObjectTemplate::New(_isolate);
+    global->Set(V8_STRING("Worker"), Worker::CreateTemplate(_isolate));
+    global->Set(V8_STRING("setTimeout"), FunctionTemplate::New(_isolate, SetTimer, v8::False(_isolate)));
+    global->Set(V8_STRING("setInterval"), FunctionTemplate::New(_isolate, SetTimer, v8::True(_isolate)));
+    global->Set(V8_STRING("clearTimeout"), FunctionTemplate::New(_isolate, ClearTimer));
+    global->Set(V8_STRING("clearInterval"), FunctionTemplate::New(_isolate, ClearTimer));
+    global->Set(V8_STRING("queueMicrotask"), FunctionTemplate::New(_isolate, QueueMicrotask));
+    Local<v8::Context> c = Context::New(_isolate, nullptr, global);
+    // v8::Context::Scope context_scope(c);
+    _context.Reset(_isolate, c);
+
+    c->Enter();
+
+
+    Local<v8::Object> g = c->Global();
+
+    Local<v8::String> gn = V8_STRING("global");
+
+    g->Set(c, gn, g).ToChecked();
+
+    _global.Reset(_isolate, c->Global());
+}
+
+void V8Context::EnterThread(size_t stackSize) {
+    _isolate->Enter();
+    // stack limit was computed for the thread that created the isolate
+    uintptr_t here;
+    _isolate->SetStackLimit(reinterpret_cast<uintptr_t>(&here) - stackSize);
+    HandleScope scope(_isolate);
+    GetContext()->Enter();
+}
+
+void V8Context::EnterIsolate() {
+    // with locker, V8 keeps stack limit of every thread that took the lock
+    _isolate->Enter();
+    HandleScope scope(_isolate);
+    GetContext()->Enter();
+}
+
+V8Response V8Context::EnableLocking() {
+    if (_locking) {
+        return V8Response_FromBoolean(true);
+    }
+    if (_jsThread != nullptr) {
+        return FromError("Locking cannot be enabled on context with its own thread");
+    }
+    ExitThread();
+    _locking = true;
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::Lock() {
+    if (!_locking) {
+        return FromError("Locking is not enabled");
+    }
+    Locker* locker = new Locker(_isolate);
+    EnterIsolate();
+    _heldLocks.push_back(locker);
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::Unlock() {
+    // only the thread holding the lock may touch _heldLocks
+    if (!_locking || !Locker::IsLocked(_isolate) || _heldLocks.empty()) {
+        return FromError("Context is not locked by this thread");
+    }
+    Locker* locker = _heldLocks.back();
+    _heldLocks.pop_back();
+    ExitThread();
+    delete locker;
+    return V8Response_FromBoolean(true);
+}
+
+void V8Context::ExitThread() {
+    {
+        HandleScope scope(_isolate);
+        GetContext()->Exit();
+    }
+    _isolate->Exit();
+}
+
+V8Response V8Context::StartThread(int stackSizeKb) {
+    if (_jsThread != nullptr) {
+        return FromError("Context already has a thread");
+    }
+    if (_locking) {
+        return FromError("Context with locking cannot have its own thread");
+    }
+    size_t stackSize = static_cast<size_t>(stackSizeKb) * 1024;
+    if (stackSize < 2 * kStackSize) {
+        stackSize = 2 * kStackSize;
+    }
+    ExitThread();
+    _jsThread = new JSThread(stackSize);
+    // leave room for native frames and CLR callbacks below the JS limit
+    size_t jsStackSize = stackSize - kStackSize / 2;
+    ThreadPlatform::Register(_isolate, _jsThread);
+    bool started = _jsThread->Start(
+            [this, jsStackSize] { EnterThread(jsStackSize); },
+            [this] { ExitThread(); },
+            [this, thread = _jsThread] {
+                if (PumpPlatformTasks(kIdlePumpMicros) > 0) {
+                    // budget may have run out with tasks left, drain again after CLR tasks
+                    thread->Post([] {});
+                }
+                platform::RunIdleTasks(_platform, _isolate, kIdleTaskSeconds);
+            });
+    if (!started) {
+        ThreadPlatform::Unregister(_isolate);
+        delete _jsThread;
+        _jsThread = nullptr;
+        EnterThread();
+        return FromError("Unable to start thread");
+    }
+    return V8Response_FromBoolean(true);
+}
+
+void V8Context::StopThread() {
+    JSThread* thread = _jsThread;
+    _jsThread = nullptr;
+    ThreadPlatform::Unregister(_isolate);
+    if (thread->IsCurrentThread()) {
+        // disposed from a task, isolate stays entered on this thread
+        thread->Detach();
+        return;
+    }
+    thread->Stop();
+    delete thread;
+    EnterThread();
+}
+
+bool V8Context::PostFromOtherThread(std::function<void()> task) {
+    JSThread* thread = _jsThread;
+    if (thread == nullptr || thread->IsCurrentThread()) {
+        return false;
+    }
+    thread->Post(std::move(task));
+    return true;
+}
+
+void V8Context::Post(std::function<void()> task, double delaySeconds) {
+    if (_jsThread != nullptr) {
+        _jsThread->Post(task, delaySeconds);
+        return;
+    }
+    V8Task* t = new V8Task();
+    t->context = this;
+    t->generation = GetGeneration();
+    t->run = task;
+    _queueTask(t, delaySeconds);
+}
+
+uint64_t V8Context::TimerClock() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+void V8Context::SetTimer(const FunctionCallbackInfo<Value> &args) {
+    Isolate* isolate = args.GetIsolate();
+    V8Context* self = V8Context::From(isolate);
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(Exception::TypeError(
+                TO_CHECKED(v8::String::NewFromUtf8(isolate, "Callback must be a function", NewStringType::kNormal))));
+        return;
+    }
+    double delay = 0;
+    if (args.Length() > 1 && !args[1]->NumberValue(isolate->GetCurrentContext()).To(&delay)) {
+        return;
+    }
+    // NaN and negative delays become zero, same as browsers
+    if (!(delay > 0)) {
+        delay = 0;
+    } else if (delay > INT32_MAX) {
+        delay = INT32_MAX;
+    }
+    bool repeat = args.Data()->IsTrue();
+
+    uint32_t id = ++self->_nextTimerId;
+    while (id == 0 || self->_timers.find(id) != self->_timers.end()) {
+        id = ++self->_nextTimerId;
+    }
+    V8Timer* t = new V8Timer();
+    t->id = id;
+    t->interval = repeat ? (delay < 1 ? 1 : static_cast<uint64_t>(delay)) : 0;
+    t->callback.Reset(isolate, args[0].As<v8::Function>());
+    for (int i = 2; i < args.Length(); i++) {
+        t->args.emplace_back(isolate, args[i]);
+    }
+    self->_timers[id] = t;
+    self->_timerWheel.Schedule(t, TimerClock() + static_cast<uint64_t>(delay));
+    self->ScheduleTimers();
+    args.GetReturnValue().Set(id);
+}
+
+void V8Context::ClearTimer(const FunctionCallbackInfo<Value> &args) {
+    Isolate* isolate = args.GetIsolate();
+    V8Context* self = V8Context::From(isolate);
+    if (args.Length() < 1 || !args[0]->IsNumber()) {
+        return;
+    }
+    uint32_t id = 0;
+    if (!args[0]->Uint32Value(isolate->GetCurrentContext()).To(&id)) {
+        return;
+    }
+    auto i = self->_timers.find(id);
+    if (i == self->_timers.end()) {
+        return;
+    }
+    V8Timer* t = i->second;
+    self->_timers.erase(i);
+    self->_timerWheel.Cancel(t);
+    if (t->running) {
+        t->cancelled = true;
+    } else {
+        delete t;
+    }
+}
+
+void V8Context::RunTimers() {
+    V8ContextLock lock(this);
+    CpuTimeScope cpuTime(_cpuTime);
+    HandleScope scope(_isolate);
+    Local<Context> context = GetContext();
+    Context::Scope contextScope(context);
+    Local<Value> global = context->Global();
+
+    // everything due is collected first and run as one batch
+    TimerList expired;
+    _timerWheel.Advance(TimerClock(), expired);
+    while (TimerNode* node = expired.PopFront()) {
+        V8Timer* t = static_cast<V8Timer*>(node);
+        bool repeat = t->interval > 0;
+        if (!repeat) {
+            _timers.erase(t->id);
+        }
+        t->running = true;
+        {
+            HandleScope callScope(_isolate);
+            TryCatch tryCatch(_isolate);
+            std::vector<Local<Value>> argv;
+            argv.reserve(t->args.size());
+            for (auto &a : t->args) {
+                argv.push_back(a.Get(_isolate));
+            }
+            Local<v8::Function> fn = t->callback.Get(_isolate);
+            if (fn->Call(context, global, static_cast<int>(argv.size()), argv.data()).IsEmpty()
+                && tryCatch.HasCaught()
+                && !tryCatch.HasTerminated()) {
+                Local<Value> error = tryCatch.Exception();
+                Local<Value> stack;
+                if (tryCatch.StackTrace(context).ToLocal(&stack)) {
+                    error = stack;
+                }
+                v8::String::Value v(_isolate, error);
+                _logger(*v, v.length());
+            }
+        }
+        t->running = false;
+        if (!repeat || t->cancelled) {
+            delete t;
+        } else {
+            _timerWheel.Schedule(t, _timerWheel.Now() + t->interval);
+        }
+    }
+    ScheduleTimers();
+}
+
+void V8Context::ScheduleTimers() {
+    uint64_t next = _timerWheel.NextExpiry();
+    if (next == UINT64_MAX || next >= _timerWakeAt) {
+        return;
+    }
+    _timerWakeAt = next;
+    uint64_t now = TimerClock();
+    double delay = next > now ? static_cast<double>(next - now) / 1000 : 0;
+    Post([this, next] {
+        if (_timerWakeAt == next) {
+            _timerWakeAt = UINT64_MAX;
+        }
+        RunTimers();
+    }, delay);
+}
+
+void V8Context::ClearTimers() {
+    for (auto &i : _timers) {
+        V8Timer* t = i.second;
+        _timerWheel.Cancel(t);
+        if (t->running) {
+            t->cancelled = true;
+        } else {
+            delete t;
+        }
+    }
+    _timers.clear();
+}
+
+V8Response V8Context::RunWithBudget(int timeoutMs, const std::function<V8Response()> &call) {
+    if (timeoutMs <= 0) {
+        return call();
+    }
+    if (_watchdog == nullptr) {
+        Watchdog* watchdog = new Watchdog(_isolate);
+        if (!watchdog->Start()) {
+            delete watchdog;
+            return FromError("Unable to start watchdog thread");
+        }
+        _watchdog = watchdog;
+    }
+    auto deadline = Watchdog::Clock::now() + std::chrono::milliseconds(timeoutMs);
+    auto previous = _watchdog->Arm(deadline);
+    V8Response r = call();
+    if (_watchdog->Disarm(previous)) {
+        // call may have returned before termination was noticed
+        _isolate->CancelTerminateExecution();
+    }
+    return r;
+}
+
+void V8Context::RequestInterrupt(ClrTask task, ClrTask cancel, ClrPointer data) {
+    uintptr_t id;
+    {
+        std::lock_guard<std::mutex> lock(_interruptLock);
+        id = ++_nextInterruptId;
+        _interrupts[id] = V8Interrupt { task, cancel, data, GetGeneration() };
+    }
+    _isolate->RequestInterrupt(&V8Context::RunInterrupt, reinterpret_cast<void*>(id));
+}
+
+void V8Context::RunInterrupt(Isolate* isolate, void* data) {
+    V8Context* self = V8Context::From(isolate);
+    V8Interrupt interrupt;
+    {
+        std::lock_guard<std::mutex> lock(self->_interruptLock);
+        auto it = self->_interrupts.find(reinterpret_cast<uintptr_t>(data));
+        if (it == self->_interrupts.end()) {
+            // already cancelled
+            return;
+        }
+        interrupt = it->second;
+        self->_interrupts.erase(it);
+    }
+    if (interrupt.generation != self->GetGeneration()) {
+        // requested for previous owner while context went to the pool
+        interrupt.cancel(interrupt.data);
+        return;
+    }
+    interrupt.task(interrupt.data);
+}
+
+void V8Context::CancelInterrupts() {
+    std::unordered_map<uintptr_t, V8Interrupt> interrupts;
+    {
+        std::lock_guard<std::mutex> lock(_interruptLock);
+        interrupts.swap(_interrupts);
+    }
+    for (auto &i : interrupts) {
+        i.second.cancel(i.second.data);
+    }
+}
+
+V8Response V8Context::CpuTimeUsed() {
+    V8Response r = {};
+    r.type = V8ResponseType::Number;
+    r.result.doubleValue = _cpuTime.totalNanos.load(std::memory_order_relaxed) / 1e6;
+    return r;
+}
+
+V8Response V8Context::StartCpuProfile(Utf16Value title, int samplingIntervalUs, bool callerLineNumbers) {
+    V8_CONTEXT_SCOPE
+    std::u16string key(reinterpret_cast<const char16_t*>(title->Value), static_cast<size_t>(title->Length));
+    Local<v8::String> v8Title = V8_UTF16STRING(title);
+    if (_cpuProfiles.count(key) != 0) {
+        return V8Response_FromBoolean(false);
+    }
+    if (samplingIntervalUs <= 0) {
+        samplingIntervalUs = kDefaultSamplingIntervalUs;
+    }
+    if (_cpuProfiler == nullptr) {
+        _cpuProfiler = CpuProfiler::New(_isolate, CpuProfilingNamingMode::kDebugNaming);
+        // base interval, profiles started later snap to multiples of it
+        _cpuProfiler->SetSamplingInterval(samplingIntervalUs);
+    }
+    CpuProfilingOptions options(
+            callerLineNumbers ? CpuProfilingMode::kCallerLineNumbers : CpuProfilingMode::kLeafNodeLineNumbers,
+            CpuProfilingOptions::kNoSampleLimit,
+            samplingIntervalUs);
+    _cpuProfiler->StartProfiling(v8Title, options);
+    _cpuProfiles.insert(std::move(key));
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::StopCpuProfile(Utf16Value title, Utf16Value path) {
+    V8_CONTEXT_SCOPE
+    std::u16string key(reinterpret_cast<const char16_t*>(title->Value), static_cast<size_t>(title->Length));
+    Local<v8::String> v8Title = V8_UTF16STRING(title);
+    Local<v8::String> v8Path = V8_UTF16STRING(path);
+    if (_cpuProfiles.erase(key) == 0) {
+        return FromError("CPU profile was not started");
+    }
+    CpuProfile* profile = _cpuProfiler->StopProfiling(v8Title);
+    bool written = false;
+    if (profile != nullptr) {
+        v8::String::Utf8Value filePath(_isolate, v8Path);
+        int fd = open(*filePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd >= 0) {
+            JsonWriter writer(fd);
+            Profiler::WriteCpuProfile(profile, writer);
+            written = writer.Flush();
+            written = close(fd) == 0 && written;
+        }
+        profile->Delete();
+    }
+    if (_cpuProfiles.empty()) {
+        // profile is owned by the profiler, dispose only after it is written
+        // and deleted, nothing is sampled once last profile is stopped
+        DisposeCpuProfiler();
+    }
+    if (profile == nullptr) {
+        return FromError("CPU profile was not found");
+    }
+    if (!written) {
+        return FromError("Unable to write CPU profile");
+    }
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::WriteHeapSnapshot(Utf16Value path, bool includeClrHandles) {
+    V8_CONTEXT_SCOPE
+    Local<v8::String> v8Path = V8_UTF16STRING(path);
+    v8::String::Utf8Value filePath(_isolate, v8Path);
+    int fd = open(*filePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return FromError("Unable to open heap snapshot file");
+    }
+    HeapProfiler* profiler = _isolate->GetHeapProfiler();
+    if (includeClrHandles) {
+        profiler->AddBuildEmbedderGraphCallback(Profiler::BuildClrHandleGraph, nullptr);
+    }
+    const HeapSnapshot* snapshot = profiler->TakeHeapSnapshot();
+    if (includeClrHandles) {
+        profiler->RemoveBuildEmbedderGraphCallback(Profiler::BuildClrHandleGraph, nullptr);
+    }
+    Profiler::FileOutputStream stream(fd);
+    snapshot->Serialize(&stream, HeapSnapshot::kJSON);
+    const_cast<HeapSnapshot*>(snapshot)->Delete();
+    bool written = close(fd) == 0 && !stream.Failed();
+    if (!written) {
+        return FromError("Unable to write heap snapshot");
+    }
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::GetHeapStatistics(__HeapStatistics* statistics, bool includeCodeStatistics) {
+    memset(statistics, 0, sizeof(__HeapStatistics));
+
+    HeapStatistics heap;
+    _isolate->GetHeapStatistics(&heap);
+    statistics->totalHeapSize = heap.total_heap_size();
+    statistics->totalHeapSizeExecutable = heap.total_heap_size_executable();
+    statistics->totalPhysicalSize = heap.total_physical_size();
+    statistics->totalAvailableSize = heap.total_available_size();
+    statistics->usedHeapSize = heap.used_heap_size();
+    statistics->heapSizeLimit = heap.heap_size_limit();
+    statistics->mallocedMemory = heap.malloced_memory();
+    statistics->peakMallocedMemory = heap.peak_malloced_memory();
+    statistics->externalMemory = heap.external_memory();
+    statistics->numberOfNativeContexts = heap.number_of_native_contexts();
+    statistics->numberOfDetachedContexts = heap.number_of_detached_contexts();
+
+    if (includeCodeStatistics) {
+        HeapCodeStatistics code;
+        if (_isolate->GetHeapCodeAndMetadataStatistics(&code)) {
+            statistics->codeAndMetadataSize = code.code_and_metadata_size();
+            statistics->bytecodeAndMetadataSize = code.bytecode_and_metadata_size();
+            statistics->externalScriptSourceSize = code.external_script_source_size();
+        }
+    }
+
+    statistics->liveHandles = _liveHandles;
+    statistics->liveWrappers = _liveWrappers;
+
+    size_t count = _isolate->NumberOfHeapSpaces();
+    if (count > static_cast<size_t>(kMaxHeapSpaces)) {
+        count = static_cast<size_t>(kMaxHeapSpaces);
+    }
+    HeapSpaceStatistics space;
+    for (size_t i = 0; i < count; i++) {
+        if (!_isolate->GetHeapSpaceStatistics(&space, i)) {
+            continue;
+        }
+        __HeapSpaceStatistics &s = statistics->spaces[statistics->spaceCount++];
+        strncpy(s.name, space.space_name(), sizeof(s.name) - 1);
+        s.size = space.space_size();
+        s.used = space.space_used_size();
+        s.available = space.space_available_size();
+        s.physical = space.physical_space_size();
+    }
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::StartTracing(Utf16Value categories, Utf16Value path) {
+    V8_CONTEXT_SCOPE
+    Local<v8::String> v8Categories = V8_UTF16STRING(categories);
+    Local<v8::String> v8Path = V8_UTF16STRING(path);
+    v8::String::Utf8Value categoryList(_isolate, v8Categories);
+    v8::String::Utf8Value filePath(_isolate, v8Path);
+    if (!Tracing::Start(*categoryList, *filePath)) {
+        return FromError("Tracing is already running or trace file can't be opened");
+    }
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::StopTracing() {
+    if (!Tracing::Stop()) {
+        return FromError("Tracing was not started or trace file could not be written");
+    }
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::StartAllocationSampling(int intervalBytes, int depth) {
+    if (intervalBytes <= 0) {
+        intervalBytes = kDefaultAllocationSamplingInterval;
+    }
+    if (depth <= 0) {
+        depth = kDefaultAllocationSamplingDepth;
+    }
+    bool started = _isolate->GetHeapProfiler()->StartSamplingHeapProfiler(
+            static_cast<uint64_t>(intervalBytes),
+            depth);
+    return V8Response_FromBoolean(started);
+}
+
+V8Response V8Context::StopAllocationSampling(Utf16Value path) {
+    V8_CONTEXT_SCOPE
+    Local<v8::String> v8Path = V8_UTF16STRING(path);
+    HeapProfiler* profiler = _isolate->GetHeapProfiler();
+    // profile must be taken before sampler is stopped
+    std::unique_ptr<AllocationProfile> profile(profiler->GetAllocationProfile());
+    profiler->StopSamplingHeapProfiler();
+    if (!profile) {
+        return FromError("Allocation sampling was not started");
+    }
+    v8::String::Utf8Value filePath(_isolate, v8Path);
+    int fd = open(*filePath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool written = false;
+    if (fd >= 0) {
+        JsonWriter writer(fd);
+        Profiler::WriteAllocationProfile(_isolate, profile.get(), writer);
+        written = writer.Flush();
+        written = close(fd) == 0 && written;
+    }
+    if (!written) {
+        return FromError("Unable to write allocation profile");
+    }
+    return V8Response_FromBoolean(true);
+}
+
+void V8Context::DisposeCpuProfiler() {
+    if (_cpuProfiler != nullptr) {
+        // profiles still running are deleted with it
+        _cpuProfiler->Dispose();
+        _cpuProfiler = nullptr;
+    }
+    _cpuProfiles.clear();
+}
+
+V8Response V8Context::SetMicrotaskPolicy(bool explicitCheckpoint) {
+    _isolate->SetMicrotasksPolicy(explicitCheckpoint ? MicrotasksPolicy::kExplicit : MicrotasksPolicy::kAuto);
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::PerformMicrotaskCheckpoint() {
+    // V8 8.0 has no Isolate::PerformMicrotaskCheckpoint, exceptions are swallowed
+    _isolate->RunMicrotasks();
+    return V8Response_FromBoolean(true);
+}
+
+int V8Context::PumpPlatformTasks(int maxMicros) {
+    auto start = std::chrono::steady_clock::now();
+    int count = 0;
+    while (platform::PumpMessageLoop(_platform, _isolate)) {
+        count++;
+        if (maxMicros > 0
+            && std::chrono::steady_clock::now() - start >= std::chrono::microseconds(maxMicros)) {
+            break;
+        }
+    }
+    return count;
+}
+
+V8Response V8Context::PumpMessageLoop(int maxMicros) {
+    return V8Response_FromInteger(PumpPlatformTasks(maxMicros));
+}
+
+V8Response V8Context::RunIdleTasks(double idleSeconds) {
+    platform::RunIdleTasks(_platform, _isolate, idleSeconds);
+    return V8Response_FromBoolean(true);
+}
+
+void V8Context::QueueMicrotask(const FunctionCallbackInfo<Value> &args) {
+    Isolate* isolate = args.GetIsolate();
+    if (args.Length() < 1 || !args[0]->IsFunction()) {
+        isolate->ThrowException(Exception::TypeError(
+                TO_CHECKED(v8::String::NewFromUtf8(isolate, "Callback must be a function", NewStringType::kNormal))));
+        return;
+    }
+    isolate->EnqueueMicrotask(args[0].As<v8::Function>());
+}
+
+void V8Context::AddWorker(std::shared_ptr<Worker> worker) {
+    _workers.push_back(worker);
+}
+
+void V8Context::RemoveWorker(Worker* worker) {
+    for (auto i = _workers.begin(); i != _workers.end(); i++) {
+        if (i->get() == worker) {
+            std::shared_ptr<Worker> w = *i;
+            _workers.erase(i);
+            w->Terminate();
+            return;
+        }
+    }
+}
+
+void V8Context::TerminateWorkers() {
+    std::vector<std::shared_ptr<Worker>> workers;
+    workers.swap(_workers);
+    for (auto &w : workers) {
+        w->Terminate();
+    }
+}
+
+void V8Context::Adopt(bool debug, ClrEnv env) {
+    _clrEnv = *env;
+    _logger = env->loggerCallback;
+    _queueTask = env->queueTask;
+    if (debug) {
+        AttachInspector();
+    }
+}
+
+void V8Context::PrepareForPool() {
+    HandleScope s(_isolate);
+    // tasks queued by previous owner must not run for the next one
+    _generation.fetch_add(1, std::memory_order_acq_rel);
+    TerminateWorkers();
+    ClearTimers();
+    _isolate->SetMicrotasksPolicy(MicrotasksPolicy::kAuto);
+    ReleaseInspector(true);
+    DisposeCpuProfiler();
+    _isolate->GetHeapProfiler()->StopSamplingHeapProfiler();
+    CancelAsyncCalls("Context disposed");
+    CancelInterrupts();
+    FreeAllWrappers();
+    // handles of previous owner are gone with it
+    _liveHandles = 0;
+    _liveWrappers = 0;
+}
+
+V8Response V8Context::AttachInspector() {
+    if (inspectorClient != nullptr) {
+        return V8Response_FromBoolean(false);
+    }
+    HandleScope scope(_isolate);
+    inspectorClient = new XV8InspectorClient(
+            this,
+            true,
+            sPlatform->Inner(),
+            &_clrEnv);
+    for (auto &realm : _realms) {
+        v8_inspector::StringView name(
+                reinterpret_cast<const uint16_t*>(realm.name.data()),
+                realm.name.size());
+        inspectorClient->ContextCreated(realm.context.Get(_isolate), name);
+    }
+    return V8Response_FromBoolean(true);
+}
+
+V8Response V8Context::DetachInspector() {
+    if (inspectorClient == nullptr) {
+        return V8Response_FromBoolean(false);
+    }
+    if (inspectorClient->IsPaused()) {
+        return FromError("Inspector cannot be detached while paused in debugger");
+    }
+    HandleScope scope(_isolate);
+    ReleaseInspector(true);
+    return V8Response_FromBoolean(true);
+}
+
+void V8Context::ReleaseInspector(bool reopen) {
+    // server thread may be waiting in Push, close wakes it before join
+    _debugMessages.Close();
+    StopInspectorServer();
+    if (inspectorClient != nullptr) {
+        delete inspectorClient;
+        inspectorClient = nullptr;
+    }
+    if (reopen) {
+        _debugMessages.Reopen();
+    }
+}
+
+void V8Context::Reset() {
+    {
+        HandleScope scope(_isolate);
+        GetContext()->Exit();
+        _context.Reset();
+        _global.Reset();
+        _realms.clear();
+    }
+    _isolate->ContextDisposedNotification();
+    CreateContext();
+}
+
 V8Response V8Context::FromException(Local<Context> &context, TryCatch &tc, const char* file, const int line) {
+    if (tc.HasTerminated()) {
+        // nothing can run in isolate till termination is cancelled
+        V8Response r = {};
+        r.type = V8ResponseType::Terminated;
+        return r;
+    }
     HandleScope s(_isolate);
     Local<Value> ex = tc.Exception();
     if (ex.IsEmpty()) {
@@ -181,6 +918,28 @@ V8Response V8Context::FromException(Local<Context> &context, TryCatch &tc, const
     return r;
 }
 
+V8Response V8Context::FromRejection(Local<Context> &context, Local<Value> reason) {
+    HandleScope s(_isolate);
+    Local<Value> text = reason;
+    if (reason->IsObject()) {
+        Local<Value> st;
+        Local<v8::Object> reasonObj = Local<v8::Object>::Cast(reason);
+        if (reasonObj->Get(context, V8_STRING("stack")).ToLocal(&st) && st->IsString()) {
+            text = st;
+        }
+    }
+    Local<v8::String> msg;
+    if (!text->ToString(context).ToLocal(&msg)) {
+        msg = V8_STRING("Promise was rejected");
+    }
+    V8Response r = CreateStringFrom(msg);
+    if (r.type == V8ResponseType::ConstCharArray) {
+        r.type = V8ResponseType::ConstError;
+    } else {
+        r.type = V8ResponseType::Error;
+    }
+    return r;
+}
 
 class V8WrappedVisitor: public PersistentHandleVisitor {
 public:
@@ -242,26 +1001,34 @@ void V8Context::FreeWrapper(V8Handle value, bool force) {
     if (!V8External::CheckoutExternal(context, v, force)) {
          // LogAndroid("FreeWrapper", "Exit");
         if (force) {
-            delete value;
+            Delete(value);
         }
     }
     // LogAndroid("FreeWrapper", "Exit");
 }
 
 void V8Context::Dispose() {
-    HandleScope s(_isolate);
     {
-
-        if (inspectorClient != nullptr) {
-            delete inspectorClient;
+        V8ContextLock lock(this);
+        HandleScope s(_isolate);
+
+        // paused loop and waiting transport threads return
+        ReleaseInspector(false);
+
+        TerminateWorkers();
+        ClearTimers();
+        CancelAsyncCalls("Context disposed");
+        CancelInterrupts();
+        FreeAllWrappers();
+        DisposeCpuProfiler();
+        _isolate->GetHeapProfiler()->StopSamplingHeapProfiler();
+        if (_watchdog != nullptr) {
+            _watchdog->Stop();
+            delete _watchdog;
+            _watchdog = nullptr;
         }
-
-        V8WrappedVisitor v;
-        v.context = this;
-        v.force = true;
-        _isolate->VisitHandlesWithClassIds(&v);
-        v.context = nullptr;
         ///Local<Context> cc = _context.Get(_isolate);
+        _realms.clear();
         _context.Reset();
 
         _wrapSymbol.Reset();
@@ -275,11 +1042,19 @@ void V8Context::Dispose() {
     // _isolate->Exit();
     _isolate->Dispose();
     // delete _isolate;
-    delete _arrayBufferAllocator;
+    _arrayBufferAllocator.reset();
     // free(ReturnValue);
 
 }
 
+void V8Context::FreeAllWrappers() {
+    V8WrappedVisitor v;
+    v.context = this;
+    v.force = true;
+    _isolate->VisitHandlesWithClassIds(&v);
+    v.context = nullptr;
+}
+
 V8Response V8Context::CreateObject() {
     V8_CONTEXT_SCOPE
     Local<Value> r = Object::New(_isolate);
@@ -322,6 +1097,32 @@ V8Response V8Context::CreateString(Utf16Value value) {
     return V8Response_From(context, r);
 }
 
+Local<v8::String> V8Context::NewString(Utf16Value value) {
+    if (value->Length == 0) {
+        return _emptyString.Get(_isolate);
+    }
+    if (!IsLatin1(value->Value, static_cast<size_t>(value->Length))) {
+        return TO_CHECKED(v8::String::NewExternalTwoByte(
+                _isolate,
+                new ExternalX16String(value->Value, value->Length, value->Handle, clrFreeHandle)));
+    }
+    Local<v8::String> r;
+    if (value->Length <= kOneByteCopyLength) {
+        uint8_t buffer[kOneByteCopyLength];
+        NarrowLatin1(value->Value, buffer, static_cast<size_t>(value->Length));
+        r = TO_CHECKED(v8::String::NewFromOneByte(_isolate, buffer, NewStringType::kNormal, value->Length));
+    } else {
+        r = TO_CHECKED(v8::String::NewExternalOneByte(
+                _isolate,
+                new ExternalX8String(value->Value, static_cast<size_t>(value->Length))));
+    }
+    // CLR string is not referenced anymore
+    if (value->Handle != nullptr) {
+        clrFreeHandle(value->Handle);
+    }
+    return r;
+}
+
 V8Response V8Context::CreateStringFrom(Local<v8::String> &value) {
     V8Response r = {};
     r.type = V8ResponseType::CharArray;
@@ -479,6 +1280,7 @@ V8Response V8Context::Wrap(void *value) {
     V8Response r = {};
     r.type = V8ResponseType::Wrapped;
     V8Handle h = new Global<Value>();
+    _liveHandles++;
     h->SetWrapperClassId(WRAPPED_CLASS);
     h->Reset(_isolate, external);
     r.address = h;
@@ -510,7 +1312,8 @@ void X8Call(const FunctionCallbackInfo<v8::Value> &args) {
     HandleScope scope(isolate);
     Isolate::Scope iscope(_isolate);
     V8Context* cc = V8Context::From(isolate);
-    Local<Context> context = cc->GetContext();
+    // function may be called from a realm
+    Local<Context> context = isolate->GetCurrentContext();
     Context::Scope context_scope(context);
     Local<Value> data = args.Data();
 
@@ -536,7 +1339,11 @@ void X8Call(const FunctionCallbackInfo<v8::Value> &args) {
     // V8Response fx = V8Response_From(context, dv);
     Local<External> ext = Local<External>::Cast(data);
     ExternalCall exCall = (ExternalCall)((V8External*)ext->Value())->Data();
-    V8Response r = exCall(target, handleArgs);
+    V8Response r;
+    {
+        Tracing::Scope traceCall("X8Call");
+        r = exCall(target, handleArgs);
+    }
 
     // free(params);
 
@@ -582,10 +1389,54 @@ V8Response V8Context::CreateFunction(
 
 V8Response V8Context::Evaluate(Utf16Value script,Utf16Value location) {
     V8_HANDLE_SCOPE
+    return Evaluate(context, script, location);
+}
 
-    TryCatch tryCatch(_isolate);
+V8Response V8Context::Evaluate(Local<Context> &context, Utf16Value script, Utf16Value location) {
     Local<v8::String> v8ScriptSrc = V8_UTF16STRING(script);
     Local<v8::String> v8ScriptLocation = V8_UTF16STRING(location);
+    return Evaluate(context, v8ScriptSrc, v8ScriptLocation);
+}
+
+V8Response V8Context::EvaluateFile(Utf16Value path, Utf16Value location) {
+    V8_HANDLE_SCOPE
+    Local<v8::String> v8Path = V8_UTF16STRING(path);
+    v8::String::Utf8Value filePath(_isolate, v8Path);
+    bool empty = false;
+    ExternalMappedString* source = ExternalMappedString::Open(*filePath, empty);
+    if (source == nullptr && !empty) {
+        FreeClrString(location);
+        return FromError("Unable to map script file");
+    }
+    Local<v8::String> v8ScriptSrc;
+    if (empty) {
+        // valid script, same as evaluating ""
+        v8ScriptSrc = _emptyString.Get(_isolate);
+    } else if (source->IsAscii()) {
+        // V8 owns the mapping from here
+        v8ScriptSrc = TO_CHECKED(v8::String::NewExternalOneByte(_isolate, source));
+    } else {
+        // one time transcode, mapping is not needed after this
+        v8ScriptSrc = TO_CHECKED(v8::String::NewFromUtf8(
+                _isolate,
+                source->data(),
+                NewStringType::kNormal,
+                static_cast<int>(source->length())));
+        delete source;
+    }
+    Local<v8::String> v8ScriptLocation;
+    if (location->Length == 0) {
+        // file path is the location, CLR string is not used
+        FreeClrString(location);
+        v8ScriptLocation = v8Path;
+    } else {
+        v8ScriptLocation = V8_UTF16STRING(location);
+    }
+    return Evaluate(context, v8ScriptSrc, v8ScriptLocation);
+}
+
+V8Response V8Context::Evaluate(Local<Context> &context, Local<v8::String> &v8ScriptSrc, Local<v8::String> &v8ScriptLocation) {
+    TryCatch tryCatch(_isolate);
 
     ScriptOrigin origin(v8ScriptLocation, v8::Integer::New(_isolate, 0) );
 
@@ -601,6 +1452,153 @@ V8Response V8Context::Evaluate(Utf16Value script,Utf16Value location) {
 }
 
 
+V8Response V8Context::CompileScript(
+        Utf16Value script,
+        Utf16Value location,
+        const uint8_t* cache,
+        int cacheLength) {
+    V8_CONTEXT_SCOPE
+    Local<v8::String> v8ScriptSrc = V8_UTF16STRING(script);
+    Local<v8::String> v8ScriptLocation = V8_UTF16STRING(location);
+    ScriptOrigin origin(v8ScriptLocation, v8::Integer::New(_isolate, 0));
+
+    ScriptCompiler::CompileOptions options = ScriptCompiler::kNoCompileOptions;
+    ScriptCompiler::CachedData* cachedData = nullptr;
+    if (cache != nullptr && cacheLength > 0) {
+        // buffer is only read during compile
+        cachedData = new ScriptCompiler::CachedData(cache, cacheLength);
+        options = ScriptCompiler::kConsumeCodeCache;
+    }
+    // source owns cachedData
+    ScriptCompiler::Source source(v8ScriptSrc, origin, cachedData);
+    Local<UnboundScript> unboundScript;
+    if (!ScriptCompiler::CompileUnboundScript(_isolate, &source, options).ToLocal(&unboundScript)) {
+        RETURN_EXCEPTION(tryCatch)
+    }
+
+    V8CompiledScript* compiled = new V8CompiledScript();
+    compiled->unboundScript.Reset(_isolate, unboundScript);
+
+    V8Response r = {};
+    r.type = V8ResponseType::CompiledScript;
+    r.address = compiled;
+    r.result.booleanValue = cachedData != nullptr && cachedData->rejected;
+    return r;
+}
+
+V8Response V8Context::RunScript(V8CompiledScript* script) {
+    V8_CONTEXT_SCOPE
+    Local<Script> s = script->unboundScript.Get(_isolate)->BindToCurrentContext();
+    Local<Value> result;
+    if (!s->Run(context).ToLocal(&result)) {
+        RETURN_EXCEPTION(tryCatch)
+    }
+    return V8Response_From(context, result);
+}
+
+V8Response V8Context::ProduceWarmCodeCache(V8CompiledScript* script) {
+    V8_HANDLE_SCOPE
+    // includes every function compiled lazily till now
+    ScriptCompiler::CachedData* data =
+            ScriptCompiler::CreateCodeCache(script->unboundScript.Get(_isolate));
+    if (data == nullptr) {
+        return FromError("Code cache could not be created");
+    }
+    V8Response r = FromByteArray(data->data, data->length);
+    delete data;
+    return r;
+}
+
+V8Response V8Context::FromByteArray(const void* data, int length) {
+    V8Response r = {};
+    r.type = V8ResponseType::ByteArray;
+    r.length = length;
+    r.address = clrAllocateMemory(length);
+    memcpy(r.address, data, static_cast<size_t>(length));
+    return r;
+}
+
+V8Response V8Context::ReleaseScript(V8CompiledScript* script) {
+    script->unboundScript.Reset();
+    delete script;
+    return V8Response_FromBoolean(true);
+}
+
+// realms can not reach each other, only the host context can reach into a realm
+static bool RealmAccessCheck(Local<Context> accessingContext, Local<v8::Object> accessedObject, Local<Value> data) {
+    V8Context* cc = V8Context::From(accessingContext->GetIsolate());
+    return accessingContext == cc->GetContext();
+}
+
+V8Response V8Context::CreateRealm(Utf16Value name) {
+    V8_CONTEXT_SCOPE
+    Local<v8::ObjectTemplate> global = ObjectTemplate::New(_isolate);
+    global->SetAccessCheckCallback(RealmAccessCheck);
+    Local<v8::Context> realm = Context::New(_isolate, nullptr, global);
+    realm->SetSecurityToken(v8::Object::New(_isolate));
+
+    Local<v8::Object> g = realm->Global();
+    g->Set(realm, V8_STRING("global"), g).ToChecked();
+
+    V8Realm entry;
+    entry.context.Reset(_isolate, realm);
+    entry.name.assign(reinterpret_cast<const char16_t*>(name->Value), static_cast<size_t>(name->Length));
+    // name is copied, CLR string is not referenced anymore
+    if (name->Handle != nullptr) {
+        clrFreeHandle(name->Handle);
+    }
+    if (inspectorClient != nullptr) {
+        v8_inspector::StringView nameView(
+                reinterpret_cast<const uint16_t*>(entry.name.data()),
+                entry.name.size());
+        inspectorClient->ContextCreated(realm, nameView);
+    }
+    _realms.push_back(std::move(entry));
+
+    Local<Value> r = g;
+    return V8Response_From(context, r);
+}
+
+std::vector<V8Realm>::iterator V8Context::FindRealm(Local<Value> g) {
+    for (auto it = _realms.begin(); it != _realms.end(); it++) {
+        if (it->context.Get(_isolate)->Global() == g) {
+            return it;
+        }
+    }
+    return _realms.end();
+}
+
+V8Response V8Context::EvaluateInRealm(V8Handle realm, Utf16Value script, Utf16Value location) {
+    V8_HANDLE_SCOPE
+    auto it = FindRealm(realm->Get(_isolate));
+    if (it == _realms.end()) {
+        // strings are released by Evaluate otherwise
+        FreeClrString(script);
+        FreeClrString(location);
+        return FromError("Realm is not a live realm of this context");
+    }
+    Local<Context> realmContext = it->context.Get(_isolate);
+    Context::Scope realmScope(realmContext);
+    V8Response r = Evaluate(realmContext, script, location);
+    return r;
+}
+
+V8Response V8Context::DisposeRealm(V8Handle realm) {
+    V8_HANDLE_SCOPE
+    auto it = FindRealm(realm->Get(_isolate));
+    if (it == _realms.end()) {
+        return V8Response_FromBoolean(false);
+    }
+    Local<Context> realmContext = it->context.Get(_isolate);
+    if (inspectorClient != nullptr) {
+        inspectorClient->ContextDestroyed(realmContext);
+    }
+    realmContext->DetachGlobal();
+    _realms.erase(it);
+    _isolate->ContextDisposedNotification();
+    return V8Response_FromBoolean(true);
+}
+
 V8Response V8Context::Release(V8Handle handle, bool post) {
     try {
         V8_CONTEXT_SCOPE
@@ -677,6 +1675,99 @@ V8Response V8Context::InvokeFunction(V8Handle target, V8Handle thisValue, int le
     return V8Response_From(context, result);
 }
 
+// both reactions share the id, promise settles only once
+void V8Context::AsyncSettled(const FunctionCallbackInfo<v8::Value> &args, bool fulfilled) {
+    V8Context* self = V8Context::From(args.GetIsolate());
+    uintptr_t id = reinterpret_cast<uintptr_t>(args.Data().As<External>()->Value());
+    auto it = self->_asyncCalls.find(id);
+    if (it == self->_asyncCalls.end()) {
+        // already cancelled when context was recycled
+        return;
+    }
+    V8AsyncCall call = it->second;
+    self->_asyncCalls.erase(it);
+    Local<Context> context = args.GetIsolate()->GetCurrentContext();
+    Local<Value> value = args[0];
+    V8Response r = fulfilled
+            ? self->V8Response_From(context, value)
+            : self->FromRejection(context, value);
+    call.completion(call.token, r);
+}
+
+void V8Context::CancelAsyncCalls(const char* reason) {
+    std::unordered_map<uintptr_t, V8AsyncCall> calls;
+    calls.swap(_asyncCalls);
+    for (auto &call : calls) {
+        call.second.completion(call.second.token, FromError(reason));
+    }
+}
+
+V8Response V8Context::InvokeAsync(
+        V8Handle target,
+        V8Handle thisValue,
+        int len,
+        void** args,
+        AsyncCompletion completion,
+        ClrPointer token) {
+    V8_CONTEXT_SCOPE
+    Local<Value> targetValue = target->Get(_isolate);
+    if (!targetValue->IsFunction()) {
+        return FromError("Target is not a function");
+    }
+    Local<v8::Object> thisValueValue =
+        (thisValue == nullptr || thisValue->IsEmpty())
+        ? _global.Get(_isolate)
+        : TO_CHECKED(thisValue->Get(_isolate)->ToObject(context));
+
+    Local<v8::Function> fx = Local<v8::Function>::Cast(targetValue);
+
+    std::vector<Local<v8::Value>> argList;
+    for (int i = 0; i < len; ++i) {
+        V8Handle h = TO_HANDLE(args[i]);
+        argList.push_back(h->Get(_isolate));
+    }
+    Local<Value> result;
+    if(!fx->Call(context, thisValueValue, len, argList.data()).ToLocal(&result)) {
+        completion(token, FromException(context, tryCatch, __FILE__, __LINE__));
+        return V8Response_FromBoolean(true);
+    }
+    if (!result->IsPromise()) {
+        completion(token, V8Response_From(context, result));
+        return V8Response_FromBoolean(true);
+    }
+
+    Local<Promise> promise = Local<Promise>::Cast(result);
+    switch (promise->State()) {
+        case Promise::PromiseState::kFulfilled: {
+            Local<Value> value = promise->Result();
+            completion(token, V8Response_From(context, value));
+            return V8Response_FromBoolean(true);
+        }
+        case Promise::PromiseState::kRejected:
+            promise->MarkAsHandled();
+            completion(token, FromRejection(context, promise->Result()));
+            return V8Response_FromBoolean(true);
+        case Promise::PromiseState::kPending:
+            break;
+    }
+
+    uintptr_t id = ++_nextAsyncCallId;
+    Local<External> data = External::New(_isolate, reinterpret_cast<void*>(id));
+    Local<v8::Function> onFulfilled = TO_CHECKED(v8::Function::New(
+            context,
+            [](const FunctionCallbackInfo<v8::Value> &a) { AsyncSettled(a, true); },
+            data, 1));
+    Local<v8::Function> onRejected = TO_CHECKED(v8::Function::New(
+            context,
+            [](const FunctionCallbackInfo<v8::Value> &a) { AsyncSettled(a, false); },
+            data, 1));
+    if (promise->Then(context, onFulfilled, onRejected).IsEmpty()) {
+        RETURN_EXCEPTION(tryCatch)
+    }
+    _asyncCalls[id] = V8AsyncCall { completion, token };
+    return V8Response_FromBoolean(false);
+}
+
 V8Response V8Context::IsInstanceOf(V8Handle target, V8Handle jsClass) {
     V8_CONTEXT_SCOPE
     Local<Value> targetValue = target->Get(_isolate);
@@ -836,6 +1927,68 @@ V8Response V8Context::DispatchDebugMessage(Utf16Value msg, bool post) {
     return V8Response_FromBoolean(true);
 }
 
+V8Response V8Context::PushDebugMessage(Utf16Value msg) {
+    bool pushed = QueueDebugMessage(msg->Value, msg->Length);
+    FreeClrString(msg);
+    return V8Response_FromBoolean(pushed);
+}
+
+void V8Context::FreeClrString(Utf16Value value) {
+    if (value->Handle != nullptr) {
+        clrFreeHandle(value->Handle);
+    }
+}
+
+bool V8Context::QueueDebugMessage(const uint16_t* text, int length) {
+    bool wasEmpty = false;
+    bool pushed = _debugMessages.Push(text, length, wasEmpty);
+    if (pushed && wasEmpty) {
+        // messages pushed after this are drained by same task
+        Post([this] {
+            DispatchDebugMessages();
+        });
+    }
+    return pushed;
+}
+
+V8Response V8Context::StartInspectorServer(int port) {
+    if (inspectorClient == nullptr) {
+        return FromError("Inspector is not attached");
+    }
+    if (_inspectorServer != nullptr) {
+        return FromError("Inspector server is already running");
+    }
+    InspectorServer* server = new InspectorServer(this, port);
+    if (!server->Start()) {
+        delete server;
+        return FromError("Could not listen on inspector port");
+    }
+    _inspectorServer = server;
+    return V8Response_FromBoolean(true);
+}
+
+void V8Context::StopInspectorServer() {
+    if (_inspectorServer != nullptr) {
+        _inspectorServer->Stop();
+        delete _inspectorServer;
+        _inspectorServer = nullptr;
+    }
+}
+
+void V8Context::DispatchDebugMessages() {
+    V8ContextLock lock(this);
+    HandleScope scope(_isolate);
+    std::u16string message;
+    while (_debugMessages.Pop(message, std::chrono::milliseconds(0))) {
+        if (inspectorClient != nullptr) {
+            v8_inspector::StringView messageView(
+                    reinterpret_cast<const uint16_t*>(message.data()),
+                    message.length());
+            inspectorClient->SendDebugMessage(messageView);
+        }
+    }
+}
+
 V8Response V8Context::ToString(V8Handle target) {
     V8_CONTEXT_SCOPE
     
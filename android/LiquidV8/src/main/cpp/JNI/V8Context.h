@@ -7,17 +7,84 @@
 
 #include "common.h"
 #include "HashMap.h"
+#include "TimerWheel.h"
+#include "Watchdog.h"
+#include "DebugMessageQueue.h"
 
 #include "v8-inspector.h"
+#include "v8-profiler.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 class XV8InspectorClient;
+class InspectorServer;
+class JSThread;
+class Worker;
+class V8Context;
 
 class V8Response;
 
+/**
+ * Compiled script held by CLR, it can be run many times and
+ * code cache can be created after it has run.
+ * **/
+struct V8CompiledScript {
+    Global<UnboundScript> unboundScript;
+};
+
+/**
+ * Task queued on host's loop when context does not have its own thread
+ * **/
+struct V8Task {
+    V8Context* context;
+    // context's generation when queued, a recycled context skips older tasks
+    uint32_t generation;
+    std::function<void()> run;
+};
+
+/**
+ * setTimeout/setInterval entry, interval is zero for timeouts
+ * **/
+struct V8Timer : public TimerNode {
+    uint32_t id = 0;
+    uint64_t interval = 0;
+    // cleared while its callback was running
+    bool running = false;
+    bool cancelled = false;
+    Global<v8::Function> callback;
+    std::vector<Global<Value>> args;
+};
+
+// context created by CreateRealm, name is kept to announce it to a later inspector
+struct V8Realm {
+    Global<Context> context;
+    std::u16string name;
+};
+
 typedef V8Response(*ExternalCall)(V8Response target, V8Response args);
 
-extern "C" {
+// receives settled value of V8Context_InvokeAsync, token is passed back as is
+typedef void (*AsyncCompletion)(ClrPointer token, V8Response result);
+
+// InvokeAsync waiting for its promise to settle
+struct V8AsyncCall {
+    AsyncCompletion completion;
+    ClrPointer token;
+};
 
-    typedef void (*BreakPauseOn)(bool value);
+// RequestInterrupt waiting for V8, cancel is called instead of task if it never runs
+struct V8Interrupt {
+    ClrTask task;
+    ClrTask cancel;
+    ClrPointer data;
+    uint32_t generation;
+};
+
+extern "C" {
 
     struct __ClrEnv {
         AllocateMemory allocateMemory;
@@ -29,15 +96,59 @@ extern "C" {
 
         ExternalCall externalCall;
         LoggerCallback loggerCallback;
-        // wait for debug message
-        ReadDebugMessage readDebugMessage;
         SendDebugMessage sendDebugMessage;
         FatalErrorCallback fatalErrorCallback;
 
-        BreakPauseOn breakPauseOn;
+        // queues a V8Task on host's loop, host runs it with V8Context_PostTask
+        QueueTask queueTask;
+
+        // optional, when set inspector messages are sent as UTF-8 chunks
+        SendDebugMessageUtf8 sendDebugMessageUtf8;
     };
 
     typedef __ClrEnv *ClrEnv;
+
+    // V8 8.0 has 8 spaces, extra entries are zero
+    static const int kMaxHeapSpaces = 12;
+
+    struct __HeapSpaceStatistics {
+        char name[32];
+        int64_t size;
+        int64_t used;
+        int64_t available;
+        int64_t physical;
+    };
+
+    /**
+     * Filled by V8Context_GetHeapStatistics, mirrored by HeapStatistics in
+     * V8Sharp, both sides must keep same order and sizes.
+     * **/
+    struct __HeapStatistics {
+        int64_t totalHeapSize;
+        int64_t totalHeapSizeExecutable;
+        int64_t totalPhysicalSize;
+        int64_t totalAvailableSize;
+        int64_t usedHeapSize;
+        int64_t heapSizeLimit;
+        int64_t mallocedMemory;
+        int64_t peakMallocedMemory;
+        int64_t externalMemory;
+        int64_t numberOfNativeContexts;
+        int64_t numberOfDetachedContexts;
+
+        // zero unless requested, collecting them walks the heap
+        int64_t codeAndMetadataSize;
+        int64_t bytecodeAndMetadataSize;
+        int64_t externalScriptSourceSize;
+
+        // V8Handle held by CLR and CLR objects wrapped in V8External
+        int32_t liveHandles;
+        int32_t liveWrappers;
+
+        int32_t spaceCount;
+        int32_t reserved;
+        __HeapSpaceStatistics spaces[kMaxHeapSpaces];
+    };
 }
 
 class V8Context {
@@ -52,23 +163,149 @@ protected:
     Global<v8::String> _emptyString;
     XV8InspectorClient* inspectorClient = nullptr;
 
+    // copy of host callbacks, inspector may be attached after constructor
+    __ClrEnv _clrEnv;
+
+    // messages from inspector transport, see PushDebugMessage
+    DebugMessageQueue _debugMessages;
+    // optional native transport, see StartInspectorServer
+    InspectorServer* _inspectorServer = nullptr;
+
+    // additional contexts sharing this isolate
+    std::vector<V8Realm> _realms;
+
+    // live realm whose global is g, end() if g is not one
+    std::vector<V8Realm>::iterator FindRealm(Local<Value> g);
+
+    // pending InvokeAsync calls, reactions hold only the id
+    std::unordered_map<uintptr_t, V8AsyncCall> _asyncCalls;
+    uintptr_t _nextAsyncCallId = 0;
+
+    static void AsyncSettled(const FunctionCallbackInfo<Value> &args, bool fulfilled);
+
+    // completes every pending call with an error, their promises are abandoned
+    void CancelAsyncCalls(const char* reason);
+
+    // pending RequestInterrupt calls, V8 holds only the id, requested from any thread
+    std::mutex _interruptLock;
+    std::unordered_map<uintptr_t, V8Interrupt> _interrupts;
+    uintptr_t _nextInterruptId = 0;
+
+    static void RunInterrupt(Isolate* isolate, void* data);
+
+    // calls cancel of every pending interrupt, V8 may still fire their ids
+    void CancelInterrupts();
+
     std::vector<__Utf16Value> dirtyStrings;
 
     // delete array allocator
-    ArrayBuffer::Allocator* _arrayBufferAllocator;
+    // shared so that ArrayBuffers transferred to workers can outlive the isolate
+    std::shared_ptr<ArrayBuffer::Allocator> _arrayBufferAllocator;
 
     LoggerCallback _logger;
 
+    QueueTask _queueTask;
+
+    JSThread* _jsThread = nullptr;
+
+    // every export takes a v8::Locker once locking is enabled
+    bool _locking = false;
+
+    // lockers taken by V8Context_Lock, owned by the locking thread
+    std::vector<Locker*> _heldLocks;
+
+    std::vector<std::shared_ptr<Worker>> _workers;
+
+    // started by first budgeted call
+    Watchdog* _watchdog = nullptr;
+
+    CpuTime _cpuTime;
+
+    // bumped by PrepareForPool, context keeps its address across owners
+    std::atomic<uint32_t> _generation { 0 };
+
+    // created by first StartCpuProfile, disposed when last profile stops
+    CpuProfiler* _cpuProfiler = nullptr;
+    std::unordered_set<std::u16string> _cpuProfiles;
+    // same as DevTools when interval is not given
+    static const int kDefaultSamplingIntervalUs = 100;
+    static const int kDefaultAllocationSamplingInterval = 512 * 1024;
+    static const int kDefaultAllocationSamplingDepth = 16;
+
+    // handles given out by NewHandle and Wrap and not yet freed
+    int _liveHandles = 0;
+    // V8External objects alive in this isolate
+    int _liveWrappers = 0;
+
+    void DisposeCpuProfiler();
+
+    // timers fire on context's loop, see Post
+    TimerWheel _timerWheel { TimerClock() };
+    std::unordered_map<uint32_t, V8Timer*> _timers;
+    uint32_t _nextTimerId = 0;
+    // earliest tick a timer task is already posted for
+    uint64_t _timerWakeAt = UINT64_MAX;
+
+    static uint64_t TimerClock();
+    static void SetTimer(const FunctionCallbackInfo<Value> &args);
+    static void ClearTimer(const FunctionCallbackInfo<Value> &args);
+    static void QueueMicrotask(const FunctionCallbackInfo<Value> &args);
+
+    // own thread pumps platform tasks whenever its queue is drained,
+    // ThreadPlatform wakes it when V8 posts a foreground task
+    static const int kIdlePumpMicros = 2000;
+    static constexpr double kIdleTaskSeconds = 0.004;
+    int PumpPlatformTasks(int maxMicros);
+    void RunTimers();
+    void ScheduleTimers();
+    void ClearTimers();
+
     std::vector<V8Handle> handles;
 
+    void CreateContext();
+
+    void FreeAllWrappers();
+
+    // stops transport and deletes inspector, queue is reopened if reopen is true
+    void ReleaseInspector(bool reopen);
+
+    V8Response Evaluate(Local<Context> &context, Utf16Value script, Utf16Value location);
+    V8Response Evaluate(Local<Context> &context, Local<v8::String> &script, Local<v8::String> &location);
+
 public:
 
+    // same as V8's default --stack-size
+    static const size_t kStackSize = 984 * 1024;
+
+    static void InitializeV8(ClrEnv env);
+
+    // CLR allocators used by static responses are set only once V8 is initialized
+    static bool IsV8Initialized();
+
+    // releases pinned CLR string once it is copied or not needed
+    static void FreeClrString(Utf16Value value);
+
+    // Latin-1 only text up to this length is copied into V8 heap
+    static const int kOneByteCopyLength = 256;
+
+    /**
+     * Latin-1 only strings become one byte strings, copied in heap if short or
+     * external otherwise, everything else stays external two byte CLR string.
+     * **/
+    Local<v8::String> NewString(Utf16Value value);
+
     V8Response CreateStringFrom(Local<v8::String> &value);
 
     V8Response FromException(Local<Context> &context, TryCatch &tc, const char* file, const int line);
 
     V8Response FromError(const char* msg);
 
+    // copies data into memory allocated by CLR, CLR frees it
+    static V8Response FromByteArray(const void* data, int length);
+
+    // error response for a rejected promise, reason may not be an Error
+    V8Response FromRejection(Local<Context> &context, Local<Value> reason);
+
     inline Platform* GetPlatform() {
         return _platform;
     }
@@ -83,6 +320,7 @@ public:
 
     inline V8Handle NewHandle() {
         V8Handle h = nullptr;
+        _liveHandles++;
         if (!handles.empty()) {
             h = handles.back();
             handles.pop_back();
@@ -94,6 +332,7 @@ public:
 
     inline void Free(V8Handle handle) {
         if (handles.size() < handles.capacity()) {
+            _liveHandles--;
             // we should remove this...
             if(handle->IsWeak()) {
                 handle->ClearWeak();
@@ -102,9 +341,24 @@ public:
             handles.push_back(handle);
             return;
         }
+        Delete(handle);
+    }
+
+    // for handles that are not returned to the free list
+    inline void Delete(V8Handle handle) {
+        _liveHandles--;
         delete handle;
     }
 
+    // kept by V8External for heap statistics
+    inline void WrapperCreated() {
+        _liveWrappers++;
+    }
+
+    inline void WrapperDeleted() {
+        _liveWrappers--;
+    }
+
     Global<Private> wrapField;
 
     static V8Context* From(Isolate* isolate) {
@@ -117,6 +371,81 @@ public:
             );
     void Dispose();
 
+    /**
+     * Contexts are entered on the thread that creates them, these move
+     * isolate and context to other thread, stack limit is set for
+     * the entering thread.
+     * **/
+    void EnterThread(size_t stackSize = kStackSize);
+    void ExitThread();
+
+    // enters isolate and context without touching stack limit
+    void EnterIsolate();
+
+    /**
+     * Switches to v8::Locker mode, context is exited on the calling thread
+     * and every export enters it on the calling thread while holding the lock.
+     * Once enabled, locking cannot be turned off.
+     * **/
+    V8Response EnableLocking();
+
+    inline bool IsLocking() {
+        return _locking;
+    }
+
+    // keeps lock across multiple calls, must be unlocked on same thread
+    V8Response Lock();
+    V8Response Unlock();
+
+    /**
+     * Explicit policy leaves microtasks queued till host performs a
+     * checkpoint, auto runs them after every outermost call.
+     * **/
+    V8Response SetMicrotaskPolicy(bool explicitCheckpoint);
+    V8Response PerformMicrotaskCheckpoint();
+
+    /**
+     * Runs foreground tasks posted by V8 platform (GC finalization,
+     * compile tasks) for at most maxMicros, zero means till queue is empty.
+     * Result is number of tasks run.
+     * **/
+    V8Response PumpMessageLoop(int maxMicros);
+    V8Response RunIdleTasks(double idleSeconds);
+
+    // workers started by `new Worker()` in this context
+    void AddWorker(std::shared_ptr<Worker> worker);
+    void RemoveWorker(Worker* worker);
+    void TerminateWorkers();
+
+    /**
+     * Moves the context to its own native thread, must be called on the
+     * thread that currently owns the context.
+     * **/
+    V8Response StartThread(int stackSizeKb);
+    // context is entered on the calling thread after this
+    void StopThread();
+
+    inline bool HasThread() {
+        return _jsThread != nullptr;
+    }
+
+    /**
+     * Runs task on context's loop, its own thread if started,
+     * host's loop otherwise.
+     * **/
+    void Post(std::function<void()> task, double delaySeconds = 0);
+
+    // posts task when context has its own thread and caller is not on it,
+    // false means caller should run task itself
+    bool PostFromOtherThread(std::function<void()> task);
+
+    // pooled context is handed out to new owner
+    void Adopt(bool debug, ClrEnv env);
+    // releases everything held by CLR before going back to pool
+    void PrepareForPool();
+    // replaces v8::Context with a fresh one, isolate is kept
+    void Reset();
+
     V8Response Release(V8Handle handle, bool post);
     void FreeWrapper(V8Handle value, bool force);
 
@@ -141,7 +470,22 @@ public:
             V8Handle value            );
     V8Response DeleteProperty(V8Handle target, Utf16Value name);
     V8Response Evaluate(Utf16Value script,Utf16Value location);
+    V8Response EvaluateFile(Utf16Value path, Utf16Value location);
+    V8Response CompileScript(Utf16Value script, Utf16Value location, const uint8_t* cache, int cacheLength);
+    V8Response RunScript(V8CompiledScript* script);
+    V8Response ProduceWarmCodeCache(V8CompiledScript* script);
+    V8Response ReleaseScript(V8CompiledScript* script);
+    V8Response CreateRealm(Utf16Value name);
+    V8Response EvaluateInRealm(V8Handle realm, Utf16Value script, Utf16Value location);
+    V8Response DisposeRealm(V8Handle realm);
     V8Response InvokeFunction(V8Handle target, V8Handle thisValue, int len, void** args);
+
+    /**
+     * Calls function and reports result through completion, once settled if
+     * result is a promise. Returns true if completion was already called.
+     * **/
+    V8Response InvokeAsync(V8Handle target, V8Handle thisValue, int len, void** args,
+                           AsyncCompletion completion, ClrPointer token);
     V8Response InvokeMethod(V8Handle target, Utf16Value name, int len, void** args);
     V8Response IsInstanceOf(V8Handle target, V8Handle jsClass);
     V8Response Equals(V8Handle left, V8Handle right);
@@ -157,16 +501,153 @@ public:
     V8Response GetPropertyAt(V8Handle target, int index);
     V8Response SetPropertyAt(V8Handle target, int index, V8Handle value);
     V8Response DispatchDebugMessage(Utf16Value message, bool post);
+
+    /**
+     * Queues inspector message from any thread without taking the lock, it is
+     * dispatched by paused debugger loop or by a task posted on context's loop.
+     * **/
+    V8Response PushDebugMessage(Utf16Value message);
+    // same as PushDebugMessage for a message owned by caller
+    bool QueueDebugMessage(const uint16_t* text, int length);
+    // JS thread, dispatches every queued message
+    void DispatchDebugMessages();
+
+    inline DebugMessageQueue* GetDebugMessages() {
+        return &_debugMessages;
+    }
+
+    /**
+     * Creates inspector and its session at runtime, DetachInspector tears
+     * them down so context runs without inspector overhead until attached
+     * again. Both return false when there was nothing to do.
+     * **/
+    V8Response AttachInspector();
+    V8Response DetachInspector();
+
+    inline bool IsInspectorAttached() {
+        return inspectorClient != nullptr;
+    }
+
+    /**
+     * Serves DevTools on 127.0.0.1:port instead of CLR's transport,
+     * inspector must be attached.
+     * **/
+    V8Response StartInspectorServer(int port);
+    void StopInspectorServer();
+
+    inline InspectorServer* GetInspectorServer() {
+        return _inspectorServer;
+    }
     V8Response Wrap(void* value);
     V8Response ToString(V8Handle target);
     V8Response GC();
 
+    /**
+     * Runs call with a time budget, once it is over execution is terminated
+     * and response is Terminated. No budget if timeoutMs is zero or less.
+     * **/
+    V8Response RunWithBudget(int timeoutMs, const std::function<V8Response()> &call);
+
+    inline CpuTime& GetCpuTime() {
+        return _cpuTime;
+    }
+
+    inline uint32_t GetGeneration() {
+        return _generation.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Runs task on the JS thread at next interrupt check of running script,
+     * or when script runs next. Safe to call from any thread without lock,
+     * task must not run script in this isolate. If context is disposed or
+     * returned to the pool first, cancel is called with data instead.
+     * **/
+    void RequestInterrupt(ClrTask task, ClrTask cancel, ClrPointer data);
+
+    // milliseconds of CPU time spent in scripts and tasks of this context
+    V8Response CpuTimeUsed();
+
+    /**
+     * Starts sampling profile with title, false if one with same title is
+     * running. Interval is in microseconds, callerLineNumbers separates
+     * nodes by line of call site instead of function's start line.
+     * **/
+    V8Response StartCpuProfile(Utf16Value title, int samplingIntervalUs, bool callerLineNumbers);
+
+    // stops profile and writes it as .cpuprofile JSON at path
+    V8Response StopCpuProfile(Utf16Value title, Utf16Value path);
+
+    /**
+     * Takes heap snapshot and streams it to path as .heapsnapshot, with
+     * includeClrHandles, handles held by CLR are added as native nodes.
+     * **/
+    V8Response WriteHeapSnapshot(Utf16Value path, bool includeClrHandles);
+
+    /**
+     * Samples an allocation every intervalBytes on average and records
+     * stacks up to depth frames, cheap enough to leave on. Zero or less
+     * uses V8's defaults. False if sampling is already running.
+     * **/
+    V8Response StartAllocationSampling(int intervalBytes, int depth);
+
+    // stops sampling and writes live sampled allocations as .heapprofile
+    V8Response StopAllocationSampling(Utf16Value path);
+
+    /**
+     * Records trace events of comma separated categories (V8's own and
+     * "xv8" for exports) into a Chrome JSON trace at path. Tracing is
+     * process wide, it covers every context. Empty categories records
+     * v8, v8.execute and xv8.
+     * **/
+    V8Response StartTracing(Utf16Value categories, Utf16Value path);
+
+    // stops tracing started by any context and finishes the trace file
+    V8Response StopTracing();
+
+    /**
+     * Fills heap, space and handle counts without allocating, cheap enough
+     * to poll. Code statistics walk the heap, so they are only collected
+     * with includeCodeStatistics.
+     * **/
+    V8Response GetHeapStatistics(__HeapStatistics* statistics, bool includeCodeStatistics);
+
     V8Response V8Response_From(Local<Context> &context, Local<Value> &handle);
 private:
 
 
 };
 
+/**
+ * Takes v8::Locker and enters isolate and context for the duration of an
+ * export, does nothing unless locking is enabled on the context.
+ * Lockers are reentrant, so nested calls from CLR callbacks are fine.
+ * **/
+class V8ContextLock {
+private:
+    V8Context* _context;
+    typename std::aligned_storage<sizeof(Locker), alignof(Locker)>::type _locker;
+
+public:
+    explicit V8ContextLock(V8Context* context):
+        _context(context->IsLocking() ? context : nullptr)
+    {
+        if (_context != nullptr) {
+            new (&_locker) Locker(_context->GetIsolate());
+            _context->EnterIsolate();
+        }
+    }
+
+    ~V8ContextLock() {
+        if (_context != nullptr) {
+            _context->ExitThread();
+            reinterpret_cast<Locker*>(&_locker)->~Locker();
+        }
+    }
+
+    V8ContextLock(const V8ContextLock&) = delete;
+    V8ContextLock& operator=(const V8ContextLock&) = delete;
+};
+
 /**
  * The class holds reference to external object.
  *
@@ -206,6 +687,7 @@ public:
         // wrapper->SetPrivate(context, wrapField, ev);
         ex->selfValue.Reset(isolate, ev);
         ex->selfValue.SetWrapperClassId(WRAPPED_CLASS);
+        V8Context::From(isolate)->WrapperCreated();
         if (data != nullptr) {
             ex->MakeWeak();
         } else {
@@ -236,6 +718,7 @@ public:
             Release(external->_handle);
             external->_data = nullptr;
             delete external;
+            V8Context::From(isolate)->WrapperDeleted();
             return true;
         }
         external->Release();
@@ -298,6 +781,7 @@ private:
         wrap->selfValue.Reset();
         Release(wrap->_handle);
         delete wrap;
+        V8Context::From(data.GetIsolate())->WrapperDeleted();
 
     }
 };
@@ -44,7 +44,15 @@ enum V8ResponseType : uint8_t {
     Error= 0x14,
     ConstError = 0x15,
 
-    ResponseArray = 0x16
+    ResponseArray = 0x16,
+
+    // address is V8CompiledScript
+    CompiledScript = 0x17,
+    // address is allocated with AllocateMemory, CLR must free it
+    ByteArray = 0x18,
+
+    // execution was terminated, no value
+    Terminated = 0x19
 };
 
 typedef union {
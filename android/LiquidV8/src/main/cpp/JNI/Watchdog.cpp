@@ -0,0 +1,79 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include "Watchdog.h"
+
+// watchdog only waits and calls TerminateExecution
+static const size_t kWatchdogStackSize = 64 * 1024;
+
+// innermost CpuTimeScope of calling thread
+thread_local CpuTimeScope* CpuTimeScope::current = nullptr;
+
+Watchdog::Watchdog(Isolate* isolate):
+    _isolate(isolate) {
+}
+
+bool Watchdog::Start() {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, kWatchdogStackSize);
+    int r = pthread_create(&_thread, &attr, &Watchdog::ThreadMain, this);
+    pthread_attr_destroy(&attr);
+    return r == 0;
+}
+
+void Watchdog::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _stopping = true;
+        _signal.notify_one();
+    }
+    pthread_join(_thread, nullptr);
+}
+
+void* Watchdog::ThreadMain(void* data) {
+    Watchdog* self = static_cast<Watchdog*>(data);
+    self->Run();
+    return nullptr;
+}
+
+Watchdog::Clock::time_point Watchdog::Arm(Clock::time_point deadline) {
+    std::lock_guard<std::mutex> lock(_lock);
+    Clock::time_point previous = _deadline;
+    if (deadline < _deadline) {
+        _deadline = deadline;
+        _signal.notify_one();
+    }
+    return previous;
+}
+
+bool Watchdog::Disarm(Clock::time_point previous) {
+    std::lock_guard<std::mutex> lock(_lock);
+    bool fired = _fired;
+    _deadline = previous;
+    if (fired && previous <= Clock::now()) {
+        // outer budget is over too, keep terminating
+        return false;
+    }
+    _fired = false;
+    _signal.notify_one();
+    return fired;
+}
+
+void Watchdog::Run() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_stopping) {
+        if (_fired || _deadline == Clock::time_point::max()) {
+            _signal.wait(lock);
+            continue;
+        }
+        if (Clock::now() >= _deadline) {
+            _fired = true;
+            // safe to call from any thread
+            _isolate->TerminateExecution();
+            continue;
+        }
+        _signal.wait_until(lock, _deadline);
+    }
+}
@@ -0,0 +1,117 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_WATCHDOG_H
+#define ANDROID_WATCHDOG_H
+
+#include <pthread.h>
+#include <time.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+#include "common.h"
+
+/**
+ * Thread that terminates execution of an isolate once the armed deadline
+ * passes. Budgets nest, inner call arms an earlier deadline and restores
+ * the outer one when it is done.
+ * **/
+class Watchdog {
+public:
+
+    typedef std::chrono::steady_clock Clock;
+
+    explicit Watchdog(Isolate* isolate);
+
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+
+    bool Start();
+    void Stop();
+
+    // returns deadline that was armed before, pass it to Disarm
+    Clock::time_point Arm(Clock::time_point deadline);
+
+    /**
+     * Restores previous deadline, returns true if execution was terminated
+     * for this budget and caller should cancel termination. If previous
+     * deadline has passed as well, termination is left for the outer call.
+     * **/
+    bool Disarm(Clock::time_point previous);
+
+private:
+
+    static void* ThreadMain(void* data);
+
+    void Run();
+
+    Isolate* _isolate;
+    pthread_t _thread = {};
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    Clock::time_point _deadline = Clock::time_point::max();
+    bool _fired = false;
+    bool _stopping = false;
+};
+
+/**
+ * CPU time spent in a context, added by every thread that runs it
+ * and read from any thread.
+ * **/
+struct CpuTime {
+    std::atomic<uint64_t> totalNanos { 0 };
+
+    static uint64_t ThreadNanos() {
+        struct timespec ts = {};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+};
+
+/**
+ * Adds CPU time of the calling thread to the context, only outermost
+ * scope of nested calls on the same thread counts. Scopes of a thread
+ * are chained through a thread local, so threads taking turns on a
+ * locked context each add their own interval.
+ * **/
+class CpuTimeScope {
+private:
+    static thread_local CpuTimeScope* current;
+
+    CpuTime& _time;
+    CpuTimeScope* _outer;
+    bool _outermost = true;
+    uint64_t _start = 0;
+
+public:
+    explicit CpuTimeScope(CpuTime& time):
+        _time(time),
+        _outer(current) {
+        for (CpuTimeScope* s = _outer; s != nullptr; s = s->_outer) {
+            if (&s->_time == &time) {
+                _outermost = false;
+                break;
+            }
+        }
+        if (_outermost) {
+            _start = CpuTime::ThreadNanos();
+        }
+        current = this;
+    }
+
+    ~CpuTimeScope() {
+        current = _outer;
+        if (_outermost) {
+            _time.totalNanos.fetch_add(CpuTime::ThreadNanos() - _start, std::memory_order_relaxed);
+        }
+    }
+
+    CpuTimeScope(const CpuTimeScope&) = delete;
+    CpuTimeScope& operator=(const CpuTimeScope&) = delete;
+};
+
+#endif //ANDROID_WATCHDOG_H
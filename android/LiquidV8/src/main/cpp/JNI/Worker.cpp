@@ -0,0 +1,460 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#include <thread>
+
+#include "Worker.h"
+#include "V8Context.h"
+#include "JSThread.h"
+
+#define WORKER_STRING(isolate, s) \
+    TO_CHECKED(v8::String::NewFromUtf8(isolate, s, v8::NewStringType::kNormal))
+
+static void ThrowTypeError(Isolate* isolate, const char* message) {
+    isolate->ThrowException(Exception::TypeError(WORKER_STRING(isolate, message)));
+}
+
+/**
+ * Workers are spread round robin over one thread per core, threads live
+ * as long as the process.
+ * **/
+static JSThread* NextWorkerThread() {
+    static std::mutex lock;
+    static std::vector<JSThread*> threads;
+    static size_t next = 0;
+    std::lock_guard<std::mutex> guard(lock);
+    if (threads.empty()) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        if (cores == 0) {
+            cores = 1;
+        }
+        for (unsigned int i = 0; i < cores; i++) {
+            JSThread* t = new JSThread(2 * V8Context::kStackSize);
+            if (t->Start([] {}, [] {})) {
+                threads.push_back(t);
+            } else {
+                delete t;
+            }
+        }
+        if (threads.empty()) {
+            return nullptr;
+        }
+    }
+    return threads[next++ % threads.size()];
+}
+
+class WorkerSerializerDelegate : public ValueSerializer::Delegate {
+private:
+    Isolate* _isolate;
+public:
+    explicit WorkerSerializerDelegate(Isolate* isolate): _isolate(isolate) {}
+
+    void ThrowDataCloneError(Local<v8::String> message) override {
+        _isolate->ThrowException(Exception::Error(message));
+    }
+};
+
+std::shared_ptr<WorkerMessage> WorkerMessage::Serialize(
+        Local<Context> &context,
+        Local<Value> value,
+        Local<Value> transfer) {
+    Isolate* isolate = context->GetIsolate();
+    HandleScope scope(isolate);
+    WorkerSerializerDelegate delegate(isolate);
+    ValueSerializer serializer(isolate, &delegate);
+
+    std::vector<Local<ArrayBuffer>> buffers;
+    if (!transfer->IsUndefined() && !transfer->IsNull()) {
+        if (!transfer->IsArray()) {
+            ThrowTypeError(isolate, "Transfer list must be an Array");
+            return nullptr;
+        }
+        Local<Array> list = transfer.As<Array>();
+        for (uint32_t i = 0; i < list->Length(); i++) {
+            Local<Value> item;
+            if (!list->Get(context, i).ToLocal(&item)) {
+                return nullptr;
+            }
+            if (!item->IsArrayBuffer()) {
+                ThrowTypeError(isolate, "Only ArrayBuffer can be transferred");
+                return nullptr;
+            }
+            Local<ArrayBuffer> ab = item.As<ArrayBuffer>();
+            if (!ab->IsDetachable()) {
+                ThrowTypeError(isolate, "ArrayBuffer cannot be transferred");
+                return nullptr;
+            }
+            for (auto &b : buffers) {
+                if (b == ab) {
+                    ThrowTypeError(isolate, "ArrayBuffer is listed twice in transfer list");
+                    return nullptr;
+                }
+            }
+            serializer.TransferArrayBuffer(static_cast<uint32_t>(buffers.size()), ab);
+            buffers.push_back(ab);
+        }
+    }
+
+    serializer.WriteHeader();
+    bool ok;
+    if (!serializer.WriteValue(context, value).To(&ok)) {
+        return nullptr;
+    }
+
+    auto message = std::make_shared<WorkerMessage>();
+    std::pair<uint8_t*, size_t> data = serializer.Release();
+    message->_data = data.first;
+    message->_size = data.second;
+
+    // sender loses access, memory itself is never copied
+    for (auto &ab : buffers) {
+        message->_arrayBuffers.push_back(ab->GetBackingStore());
+        ab->Detach();
+    }
+    return message;
+}
+
+MaybeLocal<Value> WorkerMessage::Deserialize(Local<Context> &context) {
+    Isolate* isolate = context->GetIsolate();
+    EscapableHandleScope scope(isolate);
+    ValueDeserializer deserializer(isolate, _data, _size);
+    for (size_t i = 0; i < _arrayBuffers.size(); i++) {
+        deserializer.TransferArrayBuffer(
+                static_cast<uint32_t>(i),
+                ArrayBuffer::New(isolate, _arrayBuffers[i]));
+    }
+    bool ok;
+    if (!deserializer.ReadHeader(context).To(&ok)) {
+        return MaybeLocal<Value>();
+    }
+    Local<Value> value;
+    if (!deserializer.ReadValue(context).ToLocal(&value)) {
+        return MaybeLocal<Value>();
+    }
+    return scope.Escape(value);
+}
+
+Worker::Worker(V8Context* parent, std::string script):
+    _parent(parent),
+    _platform(parent->GetPlatform()),
+    _script(std::move(script)),
+    _thread(NextWorkerThread()),
+    _terminated(false) {
+}
+
+Local<FunctionTemplate> Worker::CreateTemplate(Isolate* isolate) {
+    EscapableHandleScope scope(isolate);
+    Local<FunctionTemplate> t = FunctionTemplate::New(isolate, Construct);
+    t->SetClassName(WORKER_STRING(isolate, "Worker"));
+    t->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<Signature> signature = Signature::New(isolate, t);
+    Local<ObjectTemplate> proto = t->PrototypeTemplate();
+    proto->Set(
+            WORKER_STRING(isolate, "postMessage"),
+            FunctionTemplate::New(isolate, ParentPostMessage, Local<Value>(), signature));
+    proto->Set(
+            WORKER_STRING(isolate, "terminate"),
+            FunctionTemplate::New(isolate, ParentTerminate, Local<Value>(), signature));
+    return scope.Escape(t);
+}
+
+Worker* Worker::Unwrap(const FunctionCallbackInfo<Value> &args) {
+    return static_cast<Worker*>(args.Holder()->GetAlignedPointerFromInternalField(0));
+}
+
+void Worker::Construct(const FunctionCallbackInfo<Value> &args) {
+    Isolate* isolate = args.GetIsolate();
+    if (!args.IsConstructCall()) {
+        ThrowTypeError(isolate, "Worker constructor requires 'new'");
+        return;
+    }
+    if (args.Length() < 1 || !args[0]->IsString()) {
+        ThrowTypeError(isolate, "Worker script must be a string");
+        return;
+    }
+    v8::String::Utf8Value script(isolate, args[0]);
+    V8Context* parent = V8Context::From(isolate);
+    auto worker = std::make_shared<Worker>(parent, std::string(*script, script.length()));
+    if (worker->_thread == nullptr) {
+        ThrowTypeError(isolate, "Unable to start worker thread");
+        return;
+    }
+    Local<v8::Object> self = args.This();
+    self->SetAlignedPointerInInternalField(0, worker.get());
+    worker->_handle.Reset(isolate, self);
+    parent->AddWorker(worker);
+    worker->Start();
+}
+
+void Worker::ParentPostMessage(const FunctionCallbackInfo<Value> &args) {
+    Worker* w = Unwrap(args);
+    if (w == nullptr || w->_terminated) {
+        return;
+    }
+    Local<Context> context = args.GetIsolate()->GetCurrentContext();
+    auto message = WorkerMessage::Serialize(context, args[0], args[1]);
+    if (!message) {
+        return;
+    }
+    auto self = w->shared_from_this();
+    w->_thread->Post([self, message] {
+        self->Receive(message);
+    });
+}
+
+void Worker::ParentTerminate(const FunctionCallbackInfo<Value> &args) {
+    Worker* w = Unwrap(args);
+    if (w == nullptr) {
+        return;
+    }
+    V8Context::From(args.GetIsolate())->RemoveWorker(w);
+}
+
+void Worker::WorkerPostMessage(const FunctionCallbackInfo<Value> &args) {
+    Isolate* isolate = args.GetIsolate();
+    Worker* w = static_cast<Worker*>(isolate->GetData(0));
+    if (w->_terminated) {
+        return;
+    }
+    Local<Context> context = isolate->GetCurrentContext();
+    auto message = WorkerMessage::Serialize(context, args[0], args[1]);
+    if (!message) {
+        return;
+    }
+    w->PostToParent([message](Worker* self) {
+        self->ReceiveInParent(message);
+    });
+}
+
+void Worker::WorkerClose(const FunctionCallbackInfo<Value> &args) {
+    Worker* w = static_cast<Worker*>(args.GetIsolate()->GetData(0));
+    w->_terminated = true;
+    // current task finishes, isolate is disposed once parent lets go
+    w->PostToParent([](Worker* self) {
+        self->_parent->RemoveWorker(self);
+    });
+}
+
+void Worker::Start() {
+    auto self = shared_from_this();
+    _thread->Post([self] {
+        self->Run();
+    });
+}
+
+void Worker::Terminate() {
+    _terminated = true;
+    V8Context* parent;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        parent = _parent;
+        _parent = nullptr;
+        if (_isolate != nullptr) {
+            _isolate->TerminateExecution();
+        }
+    }
+    if (parent != nullptr && !_handle.IsEmpty()) {
+        Isolate* isolate = parent->GetIsolate();
+        HandleScope scope(isolate);
+        _handle.Get(isolate)->SetAlignedPointerInInternalField(0, nullptr);
+        _handle.Reset();
+    }
+    auto self = shared_from_this();
+    _thread->Post([self] {
+        self->DisposeIsolate();
+    });
+}
+
+void Worker::Run() {
+    if (_terminated) {
+        return;
+    }
+    Isolate::CreateParams params;
+    // transferred backing stores may outlive this isolate
+    params.array_buffer_allocator_shared =
+            std::shared_ptr<ArrayBuffer::Allocator>(ArrayBuffer::Allocator::NewDefaultAllocator());
+    Isolate* isolate = Isolate::New(params);
+    isolate->SetData(0, this);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _isolate = isolate;
+    }
+    if (_terminated) {
+        return;
+    }
+
+    Isolate::Scope isolateScope(isolate);
+    HandleScope scope(isolate);
+
+    Local<ObjectTemplate> global = ObjectTemplate::New(isolate);
+    global->Set(
+            WORKER_STRING(isolate, "postMessage"),
+            FunctionTemplate::New(isolate, WorkerPostMessage));
+    global->Set(
+            WORKER_STRING(isolate, "close"),
+            FunctionTemplate::New(isolate, WorkerClose));
+
+    Local<Context> context = Context::New(isolate, nullptr, global);
+    _context.Reset(isolate, context);
+    Context::Scope contextScope(context);
+
+    Local<v8::Object> g = context->Global();
+    g->Set(context, WORKER_STRING(isolate, "self"), g).ToChecked();
+    g->Set(context, WORKER_STRING(isolate, "global"), g).ToChecked();
+
+    TryCatch tryCatch(isolate);
+    Local<v8::String> source;
+    Local<Script> script;
+    if (!v8::String::NewFromUtf8(
+            isolate,
+            _script.c_str(),
+            NewStringType::kNormal,
+            static_cast<int>(_script.length())).ToLocal(&source)) {
+        ReportException(context, tryCatch);
+        return;
+    }
+    ScriptOrigin origin(WORKER_STRING(isolate, "worker"));
+    if (!Script::Compile(context, source, &origin).ToLocal(&script)
+        || script->Run(context).IsEmpty()) {
+        ReportException(context, tryCatch);
+    }
+    PumpTasks();
+}
+
+void Worker::Receive(std::shared_ptr<WorkerMessage> message) {
+    if (_terminated || _isolate == nullptr) {
+        return;
+    }
+    Isolate::Scope isolateScope(_isolate);
+    HandleScope scope(_isolate);
+    Local<Context> context = _context.Get(_isolate);
+    Context::Scope contextScope(context);
+    TryCatch tryCatch(_isolate);
+
+    Local<Value> data;
+    if (!message->Deserialize(context).ToLocal(&data)) {
+        ReportException(context, tryCatch);
+        return;
+    }
+    Local<v8::Object> event = v8::Object::New(_isolate);
+    event->Set(context, WORKER_STRING(_isolate, "data"), data).ToChecked();
+
+    Local<v8::Object> g = context->Global();
+    Local<Value> handler;
+    if (!g->Get(context, WORKER_STRING(_isolate, "onmessage")).ToLocal(&handler)) {
+        ReportException(context, tryCatch);
+        return;
+    }
+    if (handler->IsFunction()) {
+        Local<Value> argv[] = { event };
+        if (handler.As<Function>()->Call(context, g, 1, argv).IsEmpty()) {
+            ReportException(context, tryCatch);
+        }
+    }
+    PumpTasks();
+}
+
+void Worker::DisposeIsolate() {
+    Isolate* isolate;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        isolate = _isolate;
+        _isolate = nullptr;
+    }
+    if (isolate == nullptr) {
+        return;
+    }
+    _context.Reset();
+    isolate->Dispose();
+}
+
+void Worker::PumpTasks() {
+    while (platform::PumpMessageLoop(_platform, _isolate)) {
+    }
+}
+
+void Worker::ReportException(Local<Context> &context, TryCatch &tryCatch) {
+    if (_terminated || tryCatch.HasTerminated()) {
+        return;
+    }
+    std::string text = "Unknown error in worker";
+    Local<Value> ex = tryCatch.Exception();
+    if (!ex.IsEmpty()) {
+        Local<Value> stack;
+        if (ex->IsObject()
+            && ex.As<v8::Object>()->Get(context, WORKER_STRING(_isolate, "stack")).ToLocal(&stack)
+            && stack->IsString()) {
+            ex = stack;
+        }
+        v8::String::Utf8Value v(_isolate, ex);
+        if (*v != nullptr) {
+            text = std::string(*v, v.length());
+        }
+    }
+    PostToParent([text](Worker* self) {
+        self->ErrorInParent(text);
+    });
+}
+
+void Worker::PostToParent(std::function<void(Worker*)> task) {
+    auto self = shared_from_this();
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_parent == nullptr) {
+        return;
+    }
+    _parent->Post([self, task] {
+        // _parent is only cleared on parent thread
+        if (self->_parent != nullptr) {
+            task(self.get());
+        }
+    });
+}
+
+void Worker::CallHandler(Local<Context> &context, const char* handler, Local<Value> event) {
+    Isolate* isolate = context->GetIsolate();
+    TryCatch tryCatch(isolate);
+    Local<v8::Object> target = _handle.Get(isolate);
+    Local<Value> fn;
+    if (!target->Get(context, WORKER_STRING(isolate, handler)).ToLocal(&fn) || !fn->IsFunction()) {
+        return;
+    }
+    Local<Value> argv[] = { event };
+    if (fn.As<Function>()->Call(context, target, 1, argv).IsEmpty() && tryCatch.HasCaught()) {
+        v8::String::Utf8Value v(isolate, tryCatch.Exception());
+        _log("Worker %s failed: %s", handler, *v == nullptr ? "" : *v);
+    }
+}
+
+void Worker::ReceiveInParent(std::shared_ptr<WorkerMessage> message) {
+    V8ContextLock contextLock(_parent);
+    Isolate* isolate = _parent->GetIsolate();
+    HandleScope scope(isolate);
+    Local<Context> context = _parent->GetContext();
+    Context::Scope contextScope(context);
+    TryCatch tryCatch(isolate);
+    Local<Value> data;
+    if (!message->Deserialize(context).ToLocal(&data)) {
+        _log("Worker message could not be read");
+        return;
+    }
+    Local<v8::Object> event = v8::Object::New(isolate);
+    event->Set(context, WORKER_STRING(isolate, "data"), data).ToChecked();
+    CallHandler(context, "onmessage", event);
+}
+
+void Worker::ErrorInParent(const std::string &message) {
+    V8ContextLock contextLock(_parent);
+    Isolate* isolate = _parent->GetIsolate();
+    HandleScope scope(isolate);
+    Local<Context> context = _parent->GetContext();
+    Context::Scope contextScope(context);
+    Local<v8::Object> event = v8::Object::New(isolate);
+    Local<v8::String> text = TO_CHECKED(v8::String::NewFromUtf8(
+            isolate,
+            message.c_str(),
+            NewStringType::kNormal,
+            static_cast<int>(message.length())));
+    event->Set(context, WORKER_STRING(isolate, "message"), text).ToChecked();
+    CallHandler(context, "onerror", event);
+}
@@ -0,0 +1,110 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+#ifndef ANDROID_WORKER_H
+#define ANDROID_WORKER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+class V8Context;
+class JSThread;
+
+/**
+ * postMessage payload, written by ValueSerializer in the sending isolate
+ * and read in the receiving one. Transferred ArrayBuffers are detached by
+ * the sender and only their backing stores travel with the message.
+ * **/
+class WorkerMessage {
+private:
+    uint8_t* _data = nullptr;
+    size_t _size = 0;
+    std::vector<std::shared_ptr<BackingStore>> _arrayBuffers;
+
+public:
+
+    ~WorkerMessage() {
+        free(_data);
+    }
+
+    /**
+     * Returns nullptr with pending exception if value could not be cloned
+     * or transfer list is invalid.
+     * **/
+    static std::shared_ptr<WorkerMessage> Serialize(
+            Local<Context> &context,
+            Local<Value> value,
+            Local<Value> transfer);
+
+    MaybeLocal<Value> Deserialize(Local<Context> &context);
+};
+
+/**
+ * `new Worker(script)` runs script in a separate isolate, workers are
+ * scheduled on a fixed pool of native threads sized to the core count,
+ * a worker always runs on the same pool thread.
+ *
+ * Worker is owned by its parent V8Context till it is terminated, methods
+ * marked parent thread must only be called where parent context is used.
+ * **/
+class Worker : public std::enable_shared_from_this<Worker> {
+public:
+
+    Worker(V8Context* parent, std::string script);
+
+    // constructor installed on global of every context
+    static Local<FunctionTemplate> CreateTemplate(Isolate* isolate);
+
+    // parent thread, terminate is safe to call more than once
+    void Start();
+    void Terminate();
+
+private:
+
+    V8Context* _parent;
+    Platform* _platform;
+    Global<v8::Object> _handle;
+    const std::string _script;
+    JSThread* _thread;
+
+    // guards _parent and _isolate, both are read from other thread
+    std::mutex _lock;
+    std::atomic<bool> _terminated;
+
+    // worker thread
+    Isolate* _isolate = nullptr;
+    Global<Context> _context;
+
+    static Worker* Unwrap(const FunctionCallbackInfo<Value> &args);
+
+    static void Construct(const FunctionCallbackInfo<Value> &args);
+    static void ParentPostMessage(const FunctionCallbackInfo<Value> &args);
+    static void ParentTerminate(const FunctionCallbackInfo<Value> &args);
+
+    static void WorkerPostMessage(const FunctionCallbackInfo<Value> &args);
+    static void WorkerClose(const FunctionCallbackInfo<Value> &args);
+
+    // worker thread
+    void Run();
+    void Receive(std::shared_ptr<WorkerMessage> message);
+    void DisposeIsolate();
+    void ReportException(Local<Context> &context, TryCatch &tryCatch);
+    void PumpTasks();
+
+    // any thread, runs on parent's loop unless parent is gone
+    void PostToParent(std::function<void(Worker*)> task);
+
+    // parent thread
+    void CallHandler(Local<Context> &context, const char* handler, Local<Value> event);
+    void ReceiveInParent(std::shared_ptr<WorkerMessage> message);
+    void ErrorInParent(const std::string &message);
+};
+
+#endif //ANDROID_WORKER_H
@@ -70,10 +70,14 @@ static T Checked(const char * fileName, const int line, Maybe<T> m) {
     TO_CHECKED(v8::String::NewFromTwoByte(_isolate, s->Value, NewStringType::kNormal, s->Length))
     */
 
+/*
 #define V8_UTF16STRING(s) \
     s->Length == 0 ? _emptyString.Get(_isolate) : \
     TO_CHECKED(v8::String::NewExternalTwoByte(  \
             _isolate, new ExternalX16String(s->Value, s->Length, s->Handle, clrFreeHandle)))
+*/
+
+#define V8_UTF16STRING(s) NewString(s)
 
 typedef char* XString;
 
@@ -111,12 +115,15 @@ typedef void* (*AllocateMemory) (int length);
 
 typedef __Utf16Value (*AllocateString) (int length);
 
-typedef __Utf16Value (*ReadDebugMessage)();
-
 typedef void (*SendDebugMessage)(int len, X8String text, X16String text16);
 
+// UTF-8 text valid only during the call, final is false for all but last chunk
+typedef void (*SendDebugMessageUtf8)(const char* text, int length, bool final);
+
 typedef void (*QueueTask)(void* task, double delay);
 
+typedef void (*ClrTask)(void* data);
+
 
 enum NullableBool: int8_t {
     NotSet = 0,
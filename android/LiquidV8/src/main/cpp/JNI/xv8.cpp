@@ -2,9 +2,19 @@
 #include "V8Response.h"
 #include "V8Context.h"
 #include "HashMap.h"
+#include "IsolatePool.h"
 #include "log.h"
+#include "CallStats.h"
+#include "Tracing.h"
 
-#define INIT_CONTEXT V8Context* context = static_cast<V8Context*>(ctx);
+// every export that casts its context is counted when XV8_CALL_STATS is set
+// and traced while "xv8" category is recorded
+#define CAST_CONTEXT CALL_STATS_SCOPE TRACE_EXPORT_SCOPE V8Context* context = static_cast<V8Context*>(ctx);
+
+#define INIT_CONTEXT CAST_CONTEXT V8ContextLock contextLock(context);
+
+// exports that run script count towards context's CPU time
+#define INIT_TIMED_CONTEXT INIT_CONTEXT CpuTimeScope cpuTimeScope(context->GetCpuTime());
 
 using namespace v8;
 
@@ -49,11 +59,44 @@ extern "C" {
     }
 
 
+    void V8Context_Prewarm(int count, ClrEnv env) {
+        IsolatePool::Shared()->Prewarm(count, env);
+    }
+
+    void V8Context_SetPoolPolicy(int policy) {
+        IsolatePool::Shared()->SetPolicy((PoolPolicy)policy);
+    }
+
+    void V8Context_GetPoolStatistics(__PoolStatistics* statistics) {
+        IsolatePool::Shared()->GetStatistics(statistics);
+    }
+
+    V8Context* V8Context_AcquireFromPool(
+            bool debug,
+            ClrEnv env) {
+        V8Context* c = IsolatePool::Shared()->Acquire(debug, env);
+        if (c == nullptr) {
+            // pool is empty or was never warmed
+            c = new V8Context(debug, env);
+        }
+        _logger = env->loggerCallback;
+        auto i = reinterpret_cast<std::uintptr_t>(c);
+        map.insert(i, 1);
+        return c;
+    }
+
     void V8Context_Dispose(ClrPointer ctx) {
         try {
-            INIT_CONTEXT
+            CAST_CONTEXT
             auto i = reinterpret_cast<std::uintptr_t>(context);
             map.erase(i);
+            if (context->HasThread()) {
+                context->StopThread();
+            }
+            // pool moves contexts between threads without locker
+            if (!context->IsLocking() && IsolatePool::Shared()->Recycle(context)) {
+                return;
+            }
             context->Dispose();
             delete context;
         } catch (...) {
@@ -81,9 +124,158 @@ extern "C" {
         return context->CreateBoolean(value);
     }
 
+    // host runs task queued by QueueTask on its loop
     void V8Context_PostTask(ClrPointer tsk) {
-        // V8Task* task = static_cast<V8Task*>(tsk);
-        // task->taskRunner->PostTaskWithInterrupt(task);
+        V8Task* task = static_cast<V8Task*>(tsk);
+        if (!IsContextDisposed(task->context)
+            && task->generation == task->context->GetGeneration()) {
+            CpuTimeScope cpuTimeScope(task->context->GetCpuTime());
+            task->run();
+        }
+        delete task;
+    }
+
+    V8Response V8Context_StartThread(ClrPointer ctx, int stackSizeKb) {
+        INIT_CONTEXT
+        return context->StartThread(stackSizeKb);
+    }
+
+    // can be called from any thread
+    V8Response V8Context_Post(ClrPointer ctx, ClrTask task, ClrPointer data) {
+        CAST_CONTEXT
+        if (IsContextDisposed(context)) {
+            return V8Response_FromBoolean(false);
+        }
+        context->Post([task, data] { task(data); });
+        return V8Response_FromBoolean(true);
+    }
+
+    // 0 = auto, 1 = explicit
+    V8Response V8Context_SetMicrotaskPolicy(ClrPointer ctx, int policy) {
+        INIT_CONTEXT
+        return context->SetMicrotaskPolicy(policy == 1);
+    }
+
+    V8Response V8Context_PerformMicrotaskCheckpoint(ClrPointer ctx) {
+        INIT_CONTEXT
+        return context->PerformMicrotaskCheckpoint();
+    }
+
+    // host calls these from its loop when context has no thread of its own
+    V8Response V8Context_PumpMessageLoop(ClrPointer ctx, int maxMicros) {
+        INIT_CONTEXT
+        return context->PumpMessageLoop(maxMicros);
+    }
+
+    V8Response V8Context_RunIdleTasks(ClrPointer ctx, double idleSeconds) {
+        INIT_CONTEXT
+        return context->RunIdleTasks(idleSeconds);
+    }
+
+    // any thread, does not take the lock
+    V8Response V8Context_RequestInterrupt(ClrPointer ctx, ClrTask task, ClrTask cancel, ClrPointer data) {
+        CAST_CONTEXT
+        if (IsContextDisposed(context)) {
+            return V8Response_FromBoolean(false);
+        }
+        context->RequestInterrupt(task, cancel, data);
+        return V8Response_FromBoolean(true);
+    }
+
+    // counter is atomic, readable from any thread
+    V8Response V8Context_GetCpuTime(ClrPointer ctx) {
+        CAST_CONTEXT
+        return context->CpuTimeUsed();
+    }
+
+    V8Response V8Context_StartCpuProfile(
+            ClrPointer ctx,
+            Utf16Value title,
+            int samplingIntervalUs,
+            bool callerLineNumbers) {
+        INIT_CONTEXT
+        return context->StartCpuProfile(title, samplingIntervalUs, callerLineNumbers);
+    }
+
+    V8Response V8Context_StopCpuProfile(
+            ClrPointer ctx,
+            Utf16Value title,
+            Utf16Value path) {
+        INIT_CONTEXT
+        return context->StopCpuProfile(title, path);
+    }
+
+    V8Response V8Context_WriteHeapSnapshot(
+            ClrPointer ctx,
+            Utf16Value path,
+            bool includeClrHandles) {
+        INIT_CONTEXT
+        return context->WriteHeapSnapshot(path, includeClrHandles);
+    }
+
+    V8Response V8Context_StartAllocationSampling(
+            ClrPointer ctx,
+            int intervalBytes,
+            int depth) {
+        INIT_CONTEXT
+        return context->StartAllocationSampling(intervalBytes, depth);
+    }
+
+    V8Response V8Context_StopAllocationSampling(
+            ClrPointer ctx,
+            Utf16Value path) {
+        INIT_CONTEXT
+        return context->StopAllocationSampling(path);
+    }
+
+    V8Response V8Context_GetHeapStatistics(
+            ClrPointer ctx,
+            __HeapStatistics* statistics,
+            bool includeCodeStatistics) {
+        INIT_CONTEXT
+        return context->GetHeapStatistics(statistics, includeCodeStatistics);
+    }
+
+    V8Response V8Context_StartTracing(
+            ClrPointer ctx,
+            Utf16Value categories,
+            Utf16Value path) {
+        INIT_CONTEXT
+        return context->StartTracing(categories, path);
+    }
+
+    V8Response V8Context_StopTracing(ClrPointer ctx) {
+        INIT_CONTEXT
+        return context->StopTracing();
+    }
+
+    // process wide, see CallStats::Snapshot for layout, false before any
+    // context exists as CLR allocator is not known and nothing was counted
+    V8Response V8Context_GetCallStats() {
+        if (!V8Context::IsV8Initialized()) {
+            return V8Response_FromBoolean(false);
+        }
+        std::string snapshot = CallStats::Snapshot();
+        return V8Context::FromByteArray(snapshot.data(), static_cast<int>(snapshot.size()));
+    }
+
+    void V8Context_ResetCallStats() {
+        CallStats::Reset();
+    }
+
+    V8Response V8Context_EnableLocking(ClrPointer ctx) {
+        CAST_CONTEXT
+        return context->EnableLocking();
+    }
+
+    V8Response V8Context_Lock(ClrPointer ctx) {
+        CAST_CONTEXT
+        return context->Lock();
+    }
+
+    V8Response V8Context_Unlock(ClrPointer ctx) {
+        CAST_CONTEXT
+        return context->Unlock();
     }
 
     V8Response V8Context_CreateNumber(ClrPointer ctx, double value) {
@@ -157,7 +349,7 @@ V8Response V8Context_CreateNull(ClrPointer ctx) {
             ClrPointer target,
             int len,
             ClrPointer* args) {
-        INIT_CONTEXT
+        INIT_TIMED_CONTEXT
 
         return context->NewInstance(TO_HANDLE(target), len, args);
     }
@@ -169,19 +361,49 @@ V8Response V8Context_CreateNull(ClrPointer ctx) {
             ClrPointer thisValue,
             int len,
             ClrPointer* args) {
-        INIT_CONTEXT
+        INIT_TIMED_CONTEXT
         return context->InvokeFunction(
                 TO_HANDLE(target),
                 TO_HANDLE(thisValue), len, args);
     }
 
+    V8Response V8Context_InvokeFunctionWithBudget(
+            ClrPointer ctx,
+            ClrPointer target,
+            ClrPointer thisValue,
+            int len,
+            ClrPointer* args,
+            int timeoutMs) {
+        INIT_TIMED_CONTEXT
+        return context->RunWithBudget(timeoutMs, [&] {
+            return context->InvokeFunction(
+                    TO_HANDLE(target),
+                    TO_HANDLE(thisValue), len, args);
+        });
+    }
+
+    V8Response V8Context_InvokeAsync(
+            ClrPointer ctx,
+            ClrPointer target,
+            ClrPointer thisValue,
+            int len,
+            ClrPointer* args,
+            AsyncCompletion completion,
+            ClrPointer token) {
+        INIT_TIMED_CONTEXT
+        return context->InvokeAsync(
+                TO_HANDLE(target),
+                TO_HANDLE(thisValue), len, args,
+                completion, token);
+    }
+
     V8Response V8Context_InvokeMethod(
             ClrPointer ctx,
             ClrPointer target,
             Utf16Value name,
             int len,
             ClrPointer* args) {
-        INIT_CONTEXT
+        INIT_TIMED_CONTEXT
         return context->InvokeMethod(
                 TO_HANDLE(target), name, len, args);
     }
@@ -208,6 +430,35 @@ V8Response V8Context_CreateNull(ClrPointer ctx) {
     }
 
 
+    // transport thread, does not take the lock
+    V8Response V8Context_PushDebugMessage(
+            ClrPointer ctx,
+            Utf16Value message) {
+        CAST_CONTEXT
+        if (IsContextDisposed(context)) {
+            V8Context::FreeClrString(message);
+            return V8Response_FromBoolean(false);
+        }
+        return context->PushDebugMessage(message);
+    }
+
+    V8Response V8Context_AttachInspector(ClrPointer ctx) {
+        INIT_CONTEXT
+        return context->AttachInspector();
+    }
+
+    V8Response V8Context_DetachInspector(ClrPointer ctx) {
+        INIT_CONTEXT
+        return context->DetachInspector();
+    }
+
+    V8Response V8Context_StartInspectorServer(
+            ClrPointer ctx,
+            int port) {
+        INIT_CONTEXT
+        return context->StartInspectorServer(port);
+    }
+
     V8Response V8Context_HasProperty(
             ClrPointer ctx,
             ClrPointer  target,
@@ -296,10 +547,96 @@ V8Response V8Context_CreateNull(ClrPointer ctx) {
             ClrPointer ctx,
             Utf16Value script,
             Utf16Value location) {
-        INIT_CONTEXT
+        INIT_TIMED_CONTEXT
         return context->Evaluate(script, location);
     }
 
+    V8Response V8Context_EvaluateWithBudget(
+            ClrPointer ctx,
+            Utf16Value script,
+            Utf16Value location,
+            int timeoutMs) {
+        INIT_TIMED_CONTEXT
+        return context->RunWithBudget(timeoutMs, [&] {
+            return context->Evaluate(script, location);
+        });
+    }
+
+    V8Response V8Context_EvaluateFile(
+            ClrPointer ctx,
+            Utf16Value path,
+            Utf16Value location) {
+        INIT_TIMED_CONTEXT
+        return context->EvaluateFile(path, location);
+    }
+
+    V8Response V8Context_CompileScript(
+            ClrPointer ctx,
+            Utf16Value script,
+            Utf16Value location,
+            const uint8_t* cache,
+            int cacheLength) {
+        INIT_CONTEXT
+        return context->CompileScript(script, location, cache, cacheLength);
+    }
+
+    V8Response V8Context_RunScript(
+            ClrPointer ctx,
+            ClrPointer script) {
+        INIT_TIMED_CONTEXT
+        return context->RunScript(static_cast<V8CompiledScript*>(script));
+    }
+
+    V8Response V8Context_ProduceWarmCodeCache(
+            ClrPointer ctx,
+            ClrPointer script) {
+        INIT_CONTEXT
+        return context->ProduceWarmCodeCache(static_cast<V8CompiledScript*>(script));
+    }
+
+    V8Response V8Context_ReleaseScript(
+            ClrPointer ctx,
+            ClrPointer script) {
+        CAST_CONTEXT
+        if (IsContextDisposed(context)) {
+            return V8Response_FromBoolean(true);
+        }
+        // finalizer thread, isolate is entered on context's own thread
+        uint32_t generation = context->GetGeneration();
+        if (context->PostFromOtherThread([context, script, generation] {
+                if (!IsContextDisposed(context) && context->GetGeneration() == generation) {
+                    context->ReleaseScript(static_cast<V8CompiledScript*>(script));
+                }
+            })) {
+            return V8Response_FromBoolean(true);
+        }
+        V8ContextLock contextLock(context);
+        return context->ReleaseScript(static_cast<V8CompiledScript*>(script));
+    }
+
+    V8Response V8Context_CreateRealm(
+            ClrPointer ctx,
+            Utf16Value name) {
+        INIT_CONTEXT
+        return context->CreateRealm(name);
+    }
+
+    V8Response V8Context_EvaluateInRealm(
+            ClrPointer ctx,
+            ClrPointer realm,
+            Utf16Value script,
+            Utf16Value location) {
+        INIT_TIMED_CONTEXT
+        return context->EvaluateInRealm(TO_HANDLE(realm), script, location);
+    }
+
+    V8Response V8Context_DisposeRealm(
+            ClrPointer ctx,
+            ClrPointer realm) {
+        INIT_CONTEXT
+        return context->DisposeRealm(TO_HANDLE(realm));
+    }
+
     int V8Context_Release(V8Response r) {
 //        if (r.type == V8ResponseType::Error) {
 //            if (r.result.error.message != nullptr) {
@@ -317,10 +654,20 @@ V8Response V8Context_CreateNull(ClrPointer ctx) {
     }
 
     V8Response V8Context_ReleaseHandle(ClrPointer ctx, ClrPointer h) {
-        INIT_CONTEXT
+        CAST_CONTEXT
         if (IsContextDisposed(context)) {
             return V8Response_FromBoolean(true);
         }
+        // finalizer thread, isolate is entered on context's own thread
+        uint32_t generation = context->GetGeneration();
+        if (context->PostFromOtherThread([context, h, generation] {
+                if (!IsContextDisposed(context) && context->GetGeneration() == generation) {
+                    context->Release(TO_HANDLE(h), true);
+                }
+            })) {
+            return V8Response_FromBoolean(true);
+        }
+        V8ContextLock contextLock(context);
         return context->Release(TO_HANDLE(h), true);
     }
 
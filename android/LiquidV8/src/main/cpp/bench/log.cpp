@@ -0,0 +1,16 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+// desktop replacement of JNI/log.cpp
+#include "log.h"
+#include <cstdarg>
+#include <cstdio>
+
+void _log(const char* format, ... ) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
@@ -0,0 +1,326 @@
+//
+// Created by ackav on 19-10-2026.
+//
+
+// Drives N contexts on N threads through the exported API with a stub
+// ClrEnv, reports throughput and latency percentiles per thread count.
+//
+//   xv8bench [--threads N] [--iterations N] [--warmup N]
+//
+// thread counts run are 1, 2, 4 ... up to --threads (default: core count)
+
+#include "V8Context.h"
+#include "V8Response.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+    V8Context* V8Context_Create(bool debug, ClrEnv env);
+    void V8Context_Dispose(ClrPointer ctx);
+    V8Response V8Context_Evaluate(ClrPointer ctx, Utf16Value script, Utf16Value location);
+    V8Response V8Context_CreateFunction(ClrPointer ctx, ExternalCall fn, ClrPointer handle, Utf16Value debugDisplay);
+    V8Response V8Context_CreateObject(ClrPointer ctx);
+    V8Response V8Context_CreateNumber(ClrPointer ctx, double value);
+    V8Response V8Context_GetGlobal(ClrPointer ctx);
+    V8Response V8Context_GetProperty(ClrPointer ctx, ClrPointer target, Utf16Value text);
+    V8Response V8Context_SetProperty(ClrPointer ctx, ClrPointer target, Utf16Value text, ClrPointer value);
+    V8Response V8Context_InvokeFunction(ClrPointer ctx, ClrPointer target, ClrPointer thisValue, int len, ClrPointer* args);
+    V8Response V8Context_ReleaseHandle(ClrPointer ctx, ClrPointer h);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+// properties set and read back by every iteration
+static const int kChurnProperties = 16;
+
+/**
+ * UTF-16 copy of an ASCII literal, it must outlive every string V8 created
+ * from it, so each worker keeps its own for the life of its context.
+ * **/
+class Text {
+private:
+    std::u16string _text;
+    __Utf16Value _value;
+
+public:
+    explicit Text(const char* ascii): _text(ascii, ascii + strlen(ascii)) {
+        _value.Value = reinterpret_cast<const uint16_t*>(_text.data());
+        _value.Length = static_cast<int>(_text.length());
+        _value.Handle = nullptr;
+    }
+
+    Text(const Text&) = delete;
+    Text& operator=(const Text&) = delete;
+
+    inline Utf16Value Get() {
+        return &_value;
+    }
+};
+
+// stub ClrEnv, strings returned to CLR are plain malloc blocks
+
+static void* BenchAllocateMemory(int length) {
+    return malloc(static_cast<size_t>(length));
+}
+
+static __Utf16Value BenchAllocateString(int length) {
+    __Utf16Value v = {};
+    uint16_t* buffer = static_cast<uint16_t*>(malloc(static_cast<size_t>(length) * sizeof(uint16_t)));
+    v.Value = buffer;
+    v.Length = length;
+    v.Handle = buffer;
+    return v;
+}
+
+static void BenchFreeMemory(const void* location) {
+    free(const_cast<void*>(location));
+}
+
+static void BenchFreeHandle(const void* handle) {
+}
+
+static void BenchLogger(const uint16_t* text, int length) {
+}
+
+static void BenchFatalError(const char* location, const char* message) {
+    fprintf(stderr, "Fatal error %s %s\n", location, message);
+    abort();
+}
+
+static void BenchQueueTask(void* task, double delay) {
+    // contexts run no timers or tasks in this benchmark
+    delete static_cast<V8Task*>(task);
+}
+
+/**
+ * State of the context driven by current thread, CLR callback needs it
+ * to create its result and to release argument handles.
+ * **/
+struct BenchThread {
+    V8Context* context = nullptr;
+    // handles received in callbacks, CLR releases them when its wrappers die
+    std::vector<ClrPointer> pending;
+    std::vector<uint32_t> latencies;
+};
+
+static thread_local BenchThread* current = nullptr;
+
+static void Check(V8Response r, const char* what) {
+    if (r.type == V8ResponseType::Error || r.type == V8ResponseType::ConstError) {
+        fprintf(stderr, "%s failed\n", what);
+        exit(1);
+    }
+}
+
+static void Release(BenchThread* w, V8Response r) {
+    if (r.address != nullptr) {
+        V8Context_ReleaseHandle(w->context, r.address);
+    }
+}
+
+static void ReleasePending(BenchThread* w) {
+    for (ClrPointer h : w->pending) {
+        V8Context_ReleaseHandle(w->context, h);
+    }
+    w->pending.clear();
+}
+
+// add(a, b) implemented by "CLR"
+static V8Response BenchAdd(V8Response target, V8Response args) {
+    BenchThread* w = current;
+    V8Response* list = static_cast<V8Response*>(args.address);
+    double sum = 0;
+    for (int i = 0; i < args.length; i++) {
+        V8Response &a = list[i];
+        if (a.type == V8ResponseType::Integer) {
+            sum += a.result.intValue;
+        } else if (a.type == V8ResponseType::Number) {
+            sum += a.result.doubleValue;
+        }
+        w->pending.push_back(a.address);
+    }
+    w->pending.push_back(target.address);
+    V8Response r = V8Context_CreateNumber(w->context, sum);
+    w->pending.push_back(r.address);
+    return r;
+}
+
+static std::string ChurnName(int i) {
+    return "p" + std::to_string(i);
+}
+
+static void RunWorker(
+        BenchThread* w,
+        ClrEnv env,
+        int warmup,
+        int iterations,
+        std::atomic<int>* ready,
+        std::atomic<bool>* go) {
+    current = w;
+    w->context = V8Context_Create(false, env);
+    V8Context* c = w->context;
+
+    Text location("bench");
+    Text addName("add");
+    Text setup(
+            "var o = { x: 1 };"
+            "function work(n) { var s = 0; for (var i = 0; i < 64; i++) { s += i * n; } return s + o.x; }");
+    Text evalScript("add(o.x, 2) + work(3)");
+    std::vector<std::unique_ptr<Text>> names;
+    for (int i = 0; i < kChurnProperties; i++) {
+        names.emplace_back(new Text(ChurnName(i).c_str()));
+    }
+    Text workName("work");
+
+    Check(V8Context_Evaluate(c, setup.Get(), location.Get()), "setup");
+    V8Response global = V8Context_GetGlobal(c);
+    V8Response add = V8Context_CreateFunction(c, BenchAdd, nullptr, addName.Get());
+    Check(add, "CreateFunction");
+    Check(V8Context_SetProperty(c, global.address, addName.Get(), add.address), "SetProperty");
+    V8Response work = V8Context_GetProperty(c, global.address, workName.Get());
+    Check(work, "GetProperty");
+
+    auto iteration = [&](int n) {
+        // script that calls back into CLR
+        V8Response r = V8Context_Evaluate(c, evalScript.Get(), location.Get());
+        Check(r, "Evaluate");
+        Release(w, r);
+
+        // property churn on a fresh object
+        V8Response obj = V8Context_CreateObject(c);
+        for (int i = 0; i < kChurnProperties; i++) {
+            V8Response v = V8Context_CreateNumber(c, n + i);
+            V8Context_SetProperty(c, obj.address, names[i]->Get(), v.address);
+            Release(w, v);
+        }
+        for (int i = 0; i < kChurnProperties; i++) {
+            Release(w, V8Context_GetProperty(c, obj.address, names[i]->Get()));
+        }
+        Release(w, obj);
+
+        // plain function call with argument
+        V8Response arg = V8Context_CreateNumber(c, n);
+        ClrPointer args[] = { arg.address };
+        V8Response fr = V8Context_InvokeFunction(c, work.address, nullptr, 1, args);
+        Check(fr, "InvokeFunction");
+        Release(w, fr);
+        Release(w, arg);
+
+        ReleasePending(w);
+    };
+
+    for (int i = 0; i < warmup; i++) {
+        iteration(i);
+    }
+
+    ready->fetch_add(1);
+    while (!go->load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    w->latencies.reserve(static_cast<size_t>(iterations));
+    for (int i = 0; i < iterations; i++) {
+        auto start = Clock::now();
+        iteration(i);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        w->latencies.push_back(static_cast<uint32_t>(std::min<int64_t>(ns, UINT32_MAX)));
+    }
+
+    Release(w, work);
+    Release(w, add);
+    Release(w, global);
+    V8Context_Dispose(c);
+    current = nullptr;
+}
+
+static double Percentile(std::vector<uint32_t> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t i = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[i] / 1000.0;
+}
+
+static int IntArg(int argc, char** argv, const char* name, int value) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return atoi(argv[i + 1]);
+        }
+    }
+    return value;
+}
+
+int main(int argc, char** argv) {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    int maxThreads = IntArg(argc, argv, "--threads", cores > 0 ? cores : 4);
+    int iterations = IntArg(argc, argv, "--iterations", 20000);
+    int warmup = IntArg(argc, argv, "--warmup", 2000);
+
+    __ClrEnv env = {};
+    env.allocateMemory = BenchAllocateMemory;
+    env.allocateString = BenchAllocateString;
+    env.freeMemory = BenchFreeMemory;
+    env.freeHandle = BenchFreeHandle;
+    env.loggerCallback = BenchLogger;
+    env.fatalErrorCallback = BenchFatalError;
+    env.queueTask = BenchQueueTask;
+
+    printf("%8s %12s %10s %10s %10s %10s %10s %10s\n",
+           "threads", "iter/s", "scaling", "p50 us", "p90 us", "p99 us", "p99.9 us", "max us");
+
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+
+    double single = 0;
+    for (int threads : counts) {
+        std::vector<BenchThread> workers(static_cast<size_t>(threads));
+        std::vector<std::thread> pool;
+        std::atomic<int> ready(0);
+        std::atomic<bool> go(false);
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back(RunWorker, &workers[t], &env, warmup, iterations, &ready, &go);
+        }
+        while (ready.load() < threads) {
+            std::this_thread::yield();
+        }
+        auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto &t : pool) {
+            t.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<uint32_t> all;
+        for (auto &w : workers) {
+            all.insert(all.end(), w.latencies.begin(), w.latencies.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        double throughput = all.size() / seconds;
+        if (threads == 1) {
+            single = throughput;
+        }
+        printf("%8d %12.0f %9.2fx %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+               threads,
+               throughput,
+               single > 0 ? throughput / single : 0,
+               Percentile(all, 0.5),
+               Percentile(all, 0.9),
+               Percentile(all, 0.99),
+               Percentile(all, 0.999),
+               all.empty() ? 0 : all.back() / 1000.0);
+        fflush(stdout);
+    }
+    return 0;
+}